@@ -0,0 +1,157 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "rendering_text_compositing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark parameters.
+////////////////////////////////////////////////////////////////////////////////
+
+enum { rose_bench_row_size_max = 4096, rose_bench_row_count = 256 };
+
+static size_t const rose_bench_row_sizes[] = {7, 16, 33, 256, 1031, 4096};
+static uint32_t const rose_bench_color = 0xFFE0C090;
+
+static char const* const rose_bench_kernel_names[] = {
+    [rose_compositing_kernel_type_scalar] = "scalar",
+    [rose_compositing_kernel_type_sse2] = "sse2",
+    [rose_compositing_kernel_type_avx2] = "avx2"};
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static double
+rose_bench_time_now(void) {
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)(ts.tv_sec) * 1.0e9 + (double)(ts.tv_nsec);
+}
+
+static void
+rose_bench_fill(unsigned char* coverage, unsigned char* target, size_t size) {
+    // Note: Coverage resembles glyph rows: runs of empty, partially covered,
+    // and fully covered pixels.
+    unsigned state = 12345;
+    for(size_t i = 0; i != size; ++i) {
+        state = state * 1103515245u + 12345u;
+
+        unsigned x = (state >> 16) & 0xFF;
+        coverage[i] = ((x < 96) ? 0 : ((x > 200) ? 255 : x));
+    }
+
+    for(size_t i = 0; i != (4 * size); ++i) {
+        state = state * 1103515245u + 12345u;
+        target[i] = (unsigned char)(state >> 16);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Program entry point.
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(void) {
+    // Allocate buffers.
+    size_t size = rose_bench_row_size_max * rose_bench_row_count;
+
+    unsigned char* coverage = malloc(size);
+    unsigned char* initial = malloc(4 * size);
+    unsigned char* reference = malloc(4 * size);
+    unsigned char* target = malloc(4 * size);
+
+    if((coverage == NULL) || (initial == NULL) || (reference == NULL) ||
+       (target == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    rose_bench_fill(coverage, initial, size);
+
+    // Benchmark each row size.
+    int result = EXIT_SUCCESS;
+    for(size_t i = 0; i != (sizeof(rose_bench_row_sizes) /
+                            sizeof(rose_bench_row_sizes[0]));
+        ++i) {
+        size_t row_size = rose_bench_row_sizes[i];
+
+        // Compute reference result with the scalar kernel.
+        memcpy(reference, initial, 4 * size);
+        for(size_t j = 0; j != rose_bench_row_count; ++j) {
+            rose_compositing_kernel_obtain(
+                rose_compositing_kernel_type_scalar)(
+                reference + 4 * j * row_size, coverage + j * row_size,
+                row_size, rose_bench_color);
+        }
+
+        // Benchmark each supported kernel.
+        for(int type = 0; type != rose_compositing_kernel_type_count_;
+            ++type) {
+            rose_compositing_kernel_fn kernel =
+                rose_compositing_kernel_obtain(
+                    (enum rose_compositing_kernel_type)(type));
+
+            if(kernel == NULL) {
+                printf(
+                    "%-6s  row=%4zu  unsupported\n",
+                    rose_bench_kernel_names[type], row_size);
+
+                continue;
+            }
+
+            // Validate kernel's result.
+            memcpy(target, initial, 4 * size);
+            for(size_t j = 0; j != rose_bench_row_count; ++j) {
+                kernel(
+                    target + 4 * j * row_size, coverage + j * row_size,
+                    row_size, rose_bench_color);
+            }
+
+            if(memcmp(target, reference, 4 * row_size * rose_bench_row_count) !=
+               0) {
+                printf(
+                    "%-6s  row=%4zu  MISMATCH\n", rose_bench_kernel_names[type],
+                    row_size);
+
+                result = EXIT_FAILURE;
+                continue;
+            }
+
+            // Measure kernel's performance.
+            size_t n_iterations = (size_t)(1 << 24) / row_size + 1;
+            size_t n_pixels = 0;
+
+            double t0 = rose_bench_time_now();
+            for(size_t j = 0; j != n_iterations; ++j) {
+                size_t k = j % rose_bench_row_count;
+                kernel(
+                    target + 4 * k * row_size, coverage + k * row_size,
+                    row_size, rose_bench_color);
+
+                n_pixels += row_size;
+            }
+
+            double t1 = rose_bench_time_now();
+
+            printf(
+                "%-6s  row=%4zu  %7.3f ns/pixel\n",
+                rose_bench_kernel_names[type], row_size,
+                (t1 - t0) / (double)(n_pixels));
+        }
+    }
+
+    // Free memory.
+    free(coverage);
+    free(initial);
+    free(reference);
+    free(target);
+
+    return result;
+}
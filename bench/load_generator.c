@@ -0,0 +1,843 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+// Load generator: starts a number of synthetic xdg-shell clients which commit
+// shm buffers at the given rate, with the given size and damage pattern
+// (optionally, in fullscreen mode). When finished, prints its statistics in
+// JSON format to the standard output.
+//
+#include "xdg-shell-client-protocol.h"
+#include <wayland-client.h>
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Helper macros.
+////////////////////////////////////////////////////////////////////////////////
+
+#define unused_(x) ((void)(x))
+
+#define min_(a, b) (((a) < (b)) ? (a) : (b))
+#define max_(a, b) (((a) > (b)) ? (a) : (b))
+
+////////////////////////////////////////////////////////////////////////////////
+// Parameters definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_bench_damage_pattern {
+    // Entire buffer is redrawn each frame.
+    rose_bench_damage_pattern_full,
+
+    // A small square moves across the buffer.
+    rose_bench_damage_pattern_rect,
+
+    // Surface is committed without new buffer and without damage.
+    rose_bench_damage_pattern_none,
+    rose_bench_damage_pattern_count_
+};
+
+static char const* const rose_bench_damage_pattern_names[] = {
+    [rose_bench_damage_pattern_full] = "full",
+    [rose_bench_damage_pattern_rect] = "rect",
+    [rose_bench_damage_pattern_none] = "none"};
+
+struct rose_bench_parameters {
+    // Number of clients.
+    int client_count;
+
+    // Commit rate of each client (in Hz). Zero rate means that clients commit
+    // as soon as they receive frame done events.
+    int rate;
+
+    // Buffer size. Zero size means that clients use the size which has been
+    // configured by the compositor.
+    int width, height;
+
+    // Damage pattern, and the size of the damaged square.
+    enum rose_bench_damage_pattern damage_pattern;
+    int damage_size;
+
+    // Duration of the benchmark (in seconds).
+    int duration;
+
+    // Flag: indicates that clients request fullscreen mode.
+    bool is_fullscreen;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Client definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    // Number of buffers of each client.
+    rose_bench_buffer_count = 3,
+
+    // Buffer size which is used if neither the user nor the compositor have
+    // specified it.
+    rose_bench_default_width = 640,
+    rose_bench_default_height = 480,
+
+    // Background color of clients' buffers.
+    rose_bench_background_color = 0xFF202020
+};
+
+struct rose_bench_rectangle {
+    int x, y, width, height;
+};
+
+struct rose_bench_buffer {
+    // Underlying buffer, and its pixels.
+    struct wl_buffer* underlying;
+    uint32_t* pixels;
+
+    // A rectangle which has been drawn into the buffer the last time.
+    struct rose_bench_rectangle rectangle;
+
+    // Flag: indicates that the buffer is held by the compositor.
+    bool is_busy;
+};
+
+struct rose_bench_client {
+    // Wayland objects.
+    struct wl_display* display;
+    struct wl_registry* registry;
+
+    struct wl_compositor* compositor;
+    struct wl_shm* shm;
+    struct xdg_wm_base* wm_base;
+
+    struct wl_surface* surface;
+    struct xdg_surface* xdg_surface;
+    struct xdg_toplevel* xdg_toplevel;
+
+    // Buffers, their size, and the memory region which contains their pixels.
+    struct rose_bench_buffer buffers[rose_bench_buffer_count];
+    int width, height;
+
+    void* memory;
+    size_t memory_size;
+
+    // Size which has been configured by the compositor.
+    int configured_width, configured_height;
+
+    // A rectangle which has been committed the last time.
+    struct rose_bench_rectangle rectangle;
+
+    // Index of the next frame, and the time of the next commit (in
+    // nanoseconds).
+    uint64_t frame_index, commit_time;
+
+    // Statistics.
+    uint64_t commit_count, busy_buffer_count, frame_done_count;
+    uint64_t damage_area;
+
+    // Flags.
+    bool is_configured, is_closed, is_frame_pending, has_content;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t
+rose_bench_time_now(void) {
+    struct timespec timestamp = {};
+    clock_gettime(CLOCK_MONOTONIC, &timestamp);
+
+    return (uint64_t)(timestamp.tv_sec) * 1000000000 +
+           (uint64_t)(timestamp.tv_nsec);
+}
+
+static int
+rose_bench_create_shm_file(size_t size) {
+    // Generate a unique name.
+    static unsigned counter = 0;
+
+    char name[64] = {};
+    snprintf(
+        name, sizeof(name), "/rose-bench-%ld-%u", (long)(getpid()), counter++);
+
+    // Create a new shared memory object and unlink it immediately.
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(fd == -1) {
+        return fd;
+    } else {
+        shm_unlink(name);
+    }
+
+    // Set its size.
+    if(ftruncate(fd, (off_t)(size)) == -1) {
+        return (close(fd), -1);
+    }
+
+    return fd;
+}
+
+static void
+rose_bench_fill(
+    struct rose_bench_client* client, struct rose_bench_buffer* buffer,
+    struct rose_bench_rectangle rectangle, uint32_t color) {
+    for(int j = rectangle.y; j != (rectangle.y + rectangle.height); ++j) {
+        uint32_t* row = buffer->pixels + (size_t)(client->width) * (size_t)(j);
+        for(int i = rectangle.x; i != (rectangle.x + rectangle.width); ++i) {
+            row[i] = color;
+        }
+    }
+}
+
+static uint64_t
+rose_bench_rectangle_area(struct rose_bench_rectangle rectangle) {
+    return (uint64_t)(rectangle.width) * (uint64_t)(rectangle.height);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Event handlers.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_bench_handle_buffer_release(void* data, struct wl_buffer* buffer) {
+    unused_(buffer);
+    ((struct rose_bench_buffer*)(data))->is_busy = false;
+}
+
+static struct wl_buffer_listener const rose_bench_buffer_listener = {
+    .release = rose_bench_handle_buffer_release};
+
+static void
+rose_bench_handle_frame_done(
+    void* data, struct wl_callback* callback, uint32_t time) {
+    unused_(time);
+
+    // Obtain the client.
+    struct rose_bench_client* client = data;
+
+    // Destroy the callback, update client's state.
+    wl_callback_destroy(callback);
+
+    client->is_frame_pending = false;
+    client->frame_done_count++;
+}
+
+static struct wl_callback_listener const rose_bench_frame_listener = {
+    .done = rose_bench_handle_frame_done};
+
+static void
+rose_bench_handle_wm_base_ping(
+    void* data, struct xdg_wm_base* wm_base, uint32_t serial) {
+    unused_(data);
+    xdg_wm_base_pong(wm_base, serial);
+}
+
+static struct xdg_wm_base_listener const rose_bench_wm_base_listener = {
+    .ping = rose_bench_handle_wm_base_ping};
+
+static void
+rose_bench_handle_xdg_surface_configure(
+    void* data, struct xdg_surface* xdg_surface, uint32_t serial) {
+    xdg_surface_ack_configure(xdg_surface, serial);
+    ((struct rose_bench_client*)(data))->is_configured = true;
+}
+
+static struct xdg_surface_listener const rose_bench_xdg_surface_listener = {
+    .configure = rose_bench_handle_xdg_surface_configure};
+
+static void
+rose_bench_handle_xdg_toplevel_configure(
+    void* data, struct xdg_toplevel* xdg_toplevel, int32_t width,
+    int32_t height, struct wl_array* states) {
+    unused_(xdg_toplevel), unused_(states);
+
+    // Obtain the client.
+    struct rose_bench_client* client = data;
+
+    // Save configured size.
+    client->configured_width = width;
+    client->configured_height = height;
+}
+
+static void
+rose_bench_handle_xdg_toplevel_close(
+    void* data, struct xdg_toplevel* xdg_toplevel) {
+    unused_(xdg_toplevel);
+    ((struct rose_bench_client*)(data))->is_closed = true;
+}
+
+static struct xdg_toplevel_listener const rose_bench_xdg_toplevel_listener = {
+    .configure = rose_bench_handle_xdg_toplevel_configure,
+    .close = rose_bench_handle_xdg_toplevel_close};
+
+static void
+rose_bench_handle_registry_global(
+    void* data, struct wl_registry* registry, uint32_t name,
+    char const* interface, uint32_t version) {
+    // Obtain the client.
+    struct rose_bench_client* client = data;
+
+    // Bind required globals.
+    if((strcmp(interface, wl_compositor_interface.name) == 0) &&
+       (version >= 4)) {
+        client->compositor =
+            wl_registry_bind(registry, name, &wl_compositor_interface, 4);
+    } else if(strcmp(interface, wl_shm_interface.name) == 0) {
+        client->shm = wl_registry_bind(registry, name, &wl_shm_interface, 1);
+    } else if(strcmp(interface, xdg_wm_base_interface.name) == 0) {
+        client->wm_base =
+            wl_registry_bind(registry, name, &xdg_wm_base_interface, 1);
+
+        xdg_wm_base_add_listener(
+            client->wm_base, &rose_bench_wm_base_listener, client);
+    }
+}
+
+static void
+rose_bench_handle_registry_global_remove(
+    void* data, struct wl_registry* registry, uint32_t name) {
+    unused_(data), unused_(registry), unused_(name);
+}
+
+static struct wl_registry_listener const rose_bench_registry_listener = {
+    .global = rose_bench_handle_registry_global,
+    .global_remove = rose_bench_handle_registry_global_remove};
+
+////////////////////////////////////////////////////////////////////////////////
+// Client's buffer manipulation utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_bench_client_destroy_buffers(struct rose_bench_client* client) {
+    for(int i = 0; i != rose_bench_buffer_count; ++i) {
+        if(client->buffers[i].underlying != NULL) {
+            wl_buffer_destroy(client->buffers[i].underlying);
+        }
+
+        client->buffers[i] = (struct rose_bench_buffer){};
+    }
+
+    if(client->memory != NULL) {
+        munmap(client->memory, client->memory_size);
+    }
+
+    client->memory = NULL;
+    client->memory_size = 0;
+}
+
+static bool
+rose_bench_client_allocate_buffers(
+    struct rose_bench_client* client, int width, int height) {
+    // Destroy previous buffers.
+    rose_bench_client_destroy_buffers(client);
+
+    // Compute the size of the memory region.
+    size_t buffer_size = 4 * (size_t)(width) * (size_t)(height);
+    size_t memory_size = buffer_size * rose_bench_buffer_count;
+
+    // Create and map shared memory.
+    int fd = rose_bench_create_shm_file(memory_size);
+    if(fd == -1) {
+        return false;
+    }
+
+    void* memory =
+        mmap(NULL, memory_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if(memory == MAP_FAILED) {
+        return (close(fd), false);
+    }
+
+    client->memory = memory;
+    client->memory_size = memory_size;
+
+    client->width = width;
+    client->height = height;
+
+    // Create the buffers.
+    struct wl_shm_pool* pool =
+        wl_shm_create_pool(client->shm, fd, (int32_t)(memory_size));
+
+    for(int i = 0; i != rose_bench_buffer_count; ++i) {
+        struct rose_bench_buffer* buffer = &(client->buffers[i]);
+
+        buffer->pixels = (uint32_t*)((char*)(memory) + buffer_size * i);
+        buffer->underlying = wl_shm_pool_create_buffer(
+            pool, (int32_t)(buffer_size * i), width, height, 4 * width,
+            WL_SHM_FORMAT_XRGB8888);
+
+        wl_buffer_add_listener(
+            buffer->underlying, &rose_bench_buffer_listener, buffer);
+
+        rose_bench_fill(
+            client, buffer,
+            (struct rose_bench_rectangle){.width = width, .height = height},
+            rose_bench_background_color);
+    }
+
+    wl_shm_pool_destroy(pool);
+    close(fd);
+
+    // Buffers have no content yet.
+    client->has_content = false;
+    client->rectangle = (struct rose_bench_rectangle){};
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Client's initialization/destruction utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_bench_client_destroy(struct rose_bench_client* client) {
+    rose_bench_client_destroy_buffers(client);
+
+#define destroy_(type, x)         \
+    if(client->x != NULL) {       \
+        type##_destroy(client->x); \
+    }
+
+    destroy_(xdg_toplevel, xdg_toplevel);
+    destroy_(xdg_surface, xdg_surface);
+    destroy_(wl_surface, surface);
+    destroy_(xdg_wm_base, wm_base);
+    destroy_(wl_shm, shm);
+    destroy_(wl_compositor, compositor);
+    destroy_(wl_registry, registry);
+
+#undef destroy_
+
+    if(client->display != NULL) {
+        wl_display_disconnect(client->display);
+    }
+}
+
+static bool
+rose_bench_client_initialize(
+    struct rose_bench_client* client, int index,
+    struct rose_bench_parameters const* parameters) {
+    // Connect to the compositor.
+    if((client->display = wl_display_connect(NULL)) == NULL) {
+        return false;
+    }
+
+    // Obtain required globals.
+    client->registry = wl_display_get_registry(client->display);
+    wl_registry_add_listener(
+        client->registry, &rose_bench_registry_listener, client);
+
+    if((wl_display_roundtrip(client->display) == -1) ||
+       (client->compositor == NULL) || (client->shm == NULL) ||
+       (client->wm_base == NULL)) {
+        return false;
+    }
+
+    // Create a toplevel surface.
+    client->surface = wl_compositor_create_surface(client->compositor);
+    client->xdg_surface =
+        xdg_wm_base_get_xdg_surface(client->wm_base, client->surface);
+
+    xdg_surface_add_listener(
+        client->xdg_surface, &rose_bench_xdg_surface_listener, client);
+
+    client->xdg_toplevel = xdg_surface_get_toplevel(client->xdg_surface);
+    xdg_toplevel_add_listener(
+        client->xdg_toplevel, &rose_bench_xdg_toplevel_listener, client);
+
+    if(true) {
+        char title[64] = {};
+        snprintf(title, sizeof(title), "rose-bench-%d", index);
+
+        xdg_toplevel_set_title(client->xdg_toplevel, title);
+        xdg_toplevel_set_app_id(client->xdg_toplevel, "rose-bench");
+    }
+
+    if(parameters->is_fullscreen) {
+        xdg_toplevel_set_fullscreen(client->xdg_toplevel, NULL);
+    }
+
+    // Commit the surface, and wait for the initial configure event.
+    wl_surface_commit(client->surface);
+    while(!(client->is_configured)) {
+        if(wl_display_dispatch(client->display) == -1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Client's commit utility function.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_bench_client_commit(
+    struct rose_bench_client* client,
+    struct rose_bench_parameters const* parameters) {
+    // Do nothing if the client is not ready.
+    if(!(client->is_configured) || client->is_closed) {
+        return;
+    }
+
+    // Compute buffer size.
+    int width = parameters->width, height = parameters->height;
+    if((width == 0) || (height == 0)) {
+        width = client->configured_width;
+        height = client->configured_height;
+    }
+
+    if((width <= 0) || (height <= 0)) {
+        width = rose_bench_default_width;
+        height = rose_bench_default_height;
+    }
+
+    // Reallocate the buffers, if needed.
+    if((client->memory == NULL) || (client->width != width) ||
+       (client->height != height)) {
+        if(!rose_bench_client_allocate_buffers(client, width, height)) {
+            client->is_closed = true;
+            return;
+        }
+    }
+
+    // Request a frame done event, if needed.
+    if(parameters->rate == 0) {
+        wl_callback_add_listener(
+            wl_surface_frame(client->surface), &rose_bench_frame_listener,
+            client);
+
+        client->is_frame_pending = true;
+    }
+
+    // If the surface has content and must not be damaged, then just commit
+    // it.
+    if(client->has_content &&
+       (parameters->damage_pattern == rose_bench_damage_pattern_none)) {
+        wl_surface_commit(client->surface);
+        client->commit_count++;
+
+        return;
+    }
+
+    // Find a buffer which is not held by the compositor.
+    struct rose_bench_buffer* buffer = NULL;
+    for(int i = 0; i != rose_bench_buffer_count; ++i) {
+        if(!(client->buffers[i].is_busy)) {
+            buffer = &(client->buffers[i]);
+            break;
+        }
+    }
+
+    if(buffer == NULL) {
+        // Note: Frame done event has been requested, so a commit is still
+        // required.
+        if(client->is_frame_pending) {
+            wl_surface_commit(client->surface);
+        }
+
+        client->busy_buffer_count++;
+        return;
+    }
+
+    // Compute frame's color.
+    uint32_t color = 0xFF000000 | (uint32_t)(client->frame_index * 0x030507);
+
+    // Draw the frame, and damage the surface.
+    struct rose_bench_rectangle full = {.width = width, .height = height};
+    if(!(client->has_content) ||
+       (parameters->damage_pattern == rose_bench_damage_pattern_full)) {
+        // Fill the entire buffer.
+        rose_bench_fill(
+            client, buffer, full,
+            (client->has_content ? color : rose_bench_background_color));
+
+        wl_surface_damage_buffer(client->surface, 0, 0, width, height);
+
+        buffer->rectangle = client->rectangle = full;
+        client->damage_area += rose_bench_rectangle_area(full);
+    } else {
+        // Compute square's position.
+        int size = min_(parameters->damage_size, min_(width, height));
+        uint64_t i = client->frame_index;
+
+        struct rose_bench_rectangle rectangle = {
+            .x = (int)((i * 8) % (uint64_t)(width - size + 1)),
+            .y = (int)((i * 5) % (uint64_t)(height - size + 1)),
+            .width = size,
+            .height = size};
+
+        // Erase the square which has been drawn into this buffer previously,
+        // and draw the new one.
+        rose_bench_fill(
+            client, buffer, buffer->rectangle, rose_bench_background_color);
+
+        rose_bench_fill(client, buffer, rectangle, color);
+
+        // Damage both the new square and the previously committed one.
+        wl_surface_damage_buffer(
+            client->surface, rectangle.x, rectangle.y, rectangle.width,
+            rectangle.height);
+
+        wl_surface_damage_buffer(
+            client->surface, client->rectangle.x, client->rectangle.y,
+            client->rectangle.width, client->rectangle.height);
+
+        client->damage_area += rose_bench_rectangle_area(rectangle) +
+                               rose_bench_rectangle_area(client->rectangle);
+
+        buffer->rectangle = client->rectangle = rectangle;
+    }
+
+    // Attach the buffer, and commit the surface.
+    wl_surface_attach(client->surface, buffer->underlying, 0, 0);
+    wl_surface_commit(client->surface);
+
+    // Update client's state.
+    buffer->is_busy = true;
+    client->has_content = true;
+
+    client->frame_index++;
+    client->commit_count++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Parameter parsing utility function.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool
+rose_bench_parse_parameters(
+    int argc, char* argv[], struct rose_bench_parameters* parameters) {
+    // Initialize default parameters.
+    *parameters = (struct rose_bench_parameters){
+        .client_count = 4,
+        .rate = 60,
+        .damage_pattern = rose_bench_damage_pattern_rect,
+        .damage_size = 64,
+        .duration = 10};
+
+    // Parse the options.
+    for(int option = 0; (option = getopt(argc, argv, "n:r:s:d:D:t:f")) != -1;) {
+        switch(option) {
+            case 'n':
+                parameters->client_count = atoi(optarg);
+                break;
+
+            case 'r':
+                parameters->rate = atoi(optarg);
+                break;
+
+            case 's':
+                if(sscanf(
+                       optarg, "%dx%d", &(parameters->width),
+                       &(parameters->height)) != 2) {
+                    return false;
+                }
+
+                break;
+
+            case 'd':
+                parameters->damage_pattern = rose_bench_damage_pattern_count_;
+                for(int i = 0; i != rose_bench_damage_pattern_count_; ++i) {
+                    if(strcmp(optarg, rose_bench_damage_pattern_names[i]) ==
+                       0) {
+                        parameters->damage_pattern =
+                            (enum rose_bench_damage_pattern)(i);
+                    }
+                }
+
+                break;
+
+            case 'D':
+                parameters->damage_size = atoi(optarg);
+                break;
+
+            case 't':
+                parameters->duration = atoi(optarg);
+                break;
+
+            case 'f':
+                parameters->is_fullscreen = true;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    // Validate the parameters.
+    return (parameters->client_count > 0) && (parameters->rate >= 0) &&
+           (parameters->width >= 0) && (parameters->height >= 0) &&
+           (parameters->damage_pattern != rose_bench_damage_pattern_count_) &&
+           (parameters->damage_size > 0) && (parameters->duration > 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Program entry point.
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(int argc, char* argv[]) {
+    // Parse the parameters.
+    struct rose_bench_parameters parameters = {};
+    if(!rose_bench_parse_parameters(argc, argv, &parameters)) {
+        fprintf(
+            stderr, "usage: %s [-n clients] [-r rate] [-s WIDTHxHEIGHT] "
+                    "[-d full|rect|none] [-D damage size] [-t seconds] "
+                    "[-f]\n",
+            argv[0]);
+
+        return EXIT_FAILURE;
+    }
+
+    // Initialize the clients.
+    size_t n = (size_t)(parameters.client_count);
+
+    struct rose_bench_client* clients =
+        calloc(n, sizeof(struct rose_bench_client));
+
+    struct pollfd* fds = calloc(n, sizeof(struct pollfd));
+
+    if((clients == NULL) || (fds == NULL)) {
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_SUCCESS;
+    for(size_t i = 0; i != n; ++i) {
+        if(!rose_bench_client_initialize(
+               &(clients[i]), (int)(i), &parameters)) {
+            result = EXIT_FAILURE;
+            goto end;
+        }
+
+        fds[i] = (struct pollfd){
+            .fd = wl_display_get_fd(clients[i].display), .events = POLLIN};
+    }
+
+    // Compute commit period, schedule the first commits.
+    // Note: Commits of different clients are evenly spread over the period.
+    uint64_t period =
+        ((parameters.rate == 0) ? 0 : (1000000000 / parameters.rate));
+
+    uint64_t start_time = rose_bench_time_now();
+    uint64_t end_time =
+        start_time + 1000000000 * (uint64_t)(parameters.duration);
+
+    for(size_t i = 0; i != n; ++i) {
+        clients[i].commit_time = start_time + (period * i) / n;
+    }
+
+    // Run the main loop.
+    for(uint64_t now = start_time; now < end_time;
+        now = rose_bench_time_now()) {
+        // Perform commits which are due.
+        uint64_t wake_up_time = end_time;
+        for(size_t i = 0; i != n; ++i) {
+            struct rose_bench_client* client = &(clients[i]);
+
+            if(period == 0) {
+                if(!(client->is_frame_pending)) {
+                    rose_bench_client_commit(client, &parameters);
+                }
+            } else {
+                if(client->commit_time <= now) {
+                    rose_bench_client_commit(client, &parameters);
+
+                    // Note: If the client lags behind, then missed commits are
+                    // skipped.
+                    client->commit_time =
+                        max_(client->commit_time + period, now);
+                }
+
+                wake_up_time = min_(wake_up_time, client->commit_time);
+            }
+        }
+
+        // Prepare to read events, flush the requests.
+        for(size_t i = 0; i != n; ++i) {
+            while(wl_display_prepare_read(clients[i].display) != 0) {
+                wl_display_dispatch_pending(clients[i].display);
+            }
+
+            wl_display_flush(clients[i].display);
+        }
+
+        // Wait for events.
+        now = rose_bench_time_now();
+        int timeout = ((wake_up_time > now)
+                           ? (int)((wake_up_time - now + 999999) / 1000000)
+                           : 0);
+
+        poll(fds, n, timeout);
+
+        // Read and dispatch the events.
+        bool is_finished = true;
+        for(size_t i = 0; i != n; ++i) {
+            struct rose_bench_client* client = &(clients[i]);
+
+            if((fds[i].revents & POLLIN) != 0) {
+                wl_display_read_events(client->display);
+            } else {
+                wl_display_cancel_read(client->display);
+            }
+
+            if(wl_display_dispatch_pending(client->display) == -1) {
+                client->is_closed = true;
+            }
+
+            is_finished = is_finished && client->is_closed;
+        }
+
+        if(is_finished) {
+            break;
+        }
+    }
+
+    // Print the statistics.
+    if(true) {
+        struct rose_bench_client total = {};
+        for(size_t i = 0; i != n; ++i) {
+            total.commit_count += clients[i].commit_count;
+            total.busy_buffer_count += clients[i].busy_buffer_count;
+            total.frame_done_count += clients[i].frame_done_count;
+            total.damage_area += clients[i].damage_area;
+        }
+
+        printf(
+            "{\"client_count\": %d, \"rate\": %d, \"width\": %d, "
+            "\"height\": %d,\n \"damage_pattern\": \"%s\", "
+            "\"damage_size\": %d, \"duration_ms\": %" PRIu64 ",\n"
+            " \"commit_count\": %" PRIu64 ", \"busy_buffer_count\": %" PRIu64
+            ", \"frame_done_count\": %" PRIu64 ", \"damage_area\": %" PRIu64
+            "}\n",
+            parameters.client_count, parameters.rate, parameters.width,
+            parameters.height,
+            rose_bench_damage_pattern_names[parameters.damage_pattern],
+            parameters.damage_size,
+            (rose_bench_time_now() - start_time) / 1000000, total.commit_count,
+            total.busy_buffer_count, total.frame_done_count,
+            total.damage_area);
+    }
+
+end:
+
+    // Destroy the clients.
+    for(size_t i = 0; i != n; ++i) {
+        rose_bench_client_destroy(&(clients[i]));
+    }
+
+    free(clients);
+    free(fds);
+
+    return result;
+}
@@ -0,0 +1,164 @@
+#!/bin/sh
+# Copyright Nezametdinov E. Ildus 2025.
+# Distributed under the GNU General Public License, Version 3.
+# (See accompanying file LICENSE_GPL_3_0.txt or copy at
+# https://www.gnu.org/licenses/gpl-3.0.txt)
+#
+# Runs the Compositor on wlroots' headless backend, drives it with the load
+# generator, and writes a combined JSON report.
+#
+# Usage: run.sh COMPOSITOR LOAD_GENERATOR REPORT [LOAD GENERATOR OPTIONS...]
+#
+# Renderer can be specified in the $ROSE_BENCH_RENDERER environment variable:
+#  * software - pixman renderer with direct software composition (default);
+#  * pixman - pixman renderer with wlroots' rendering passes;
+#  * gles2 - GLES2 renderer.
+#
+# Font file can be specified in the $ROSE_BENCH_FONT environment variable,
+# otherwise it is obtained from fontconfig.
+#
+# Screen capture checker's command line (without the report file) can be
+# specified in the $ROSE_BENCH_SCREENCOPY environment variable. In this case the
+# checker is started as Compositor's DISPATCHER, its report is added to the
+# combined report, and the script fails if the check fails.
+#
+set -eu
+
+compositor=$1
+load_generator=$2
+report=$3
+shift 3
+
+# Create a temporary directory which contains Compositor's configuration and
+# runtime directory.
+directory=$(mktemp -d)
+pid=
+
+clean_up() {
+    if [ -n "$pid" ]; then
+        kill "$pid" 2>/dev/null || true
+    fi
+
+    rm -rf "$directory"
+}
+
+trap clean_up EXIT
+
+mkdir -p "$directory/home/.config/rosewm" "$directory/runtime"
+chmod 700 "$directory/runtime"
+
+# Configure the renderer.
+renderer=${ROSE_BENCH_RENDERER:-software}
+case "$renderer" in
+    software)
+        wlr_renderer=pixman
+        software_composition=1
+        ;;
+    pixman)
+        wlr_renderer=pixman
+        software_composition=0
+        ;;
+    gles2)
+        wlr_renderer=gles2
+        software_composition=0
+        ;;
+    *)
+        echo "run.sh: unknown renderer: $renderer" >&2
+        exit 1
+        ;;
+esac
+
+# Configure the fonts.
+font=${ROSE_BENCH_FONT:-$(fc-match -f '%{file}' sans 2>/dev/null || true)}
+if [ -z "$font" ]; then
+    echo "run.sh: no font found, set ROSE_BENCH_FONT" >&2
+    exit 1
+fi
+
+printf '%s\n' "$font" > "$directory/home/.config/rosewm/fonts"
+
+# Configure the terminal (it is mandatory, but never started).
+printf 'true\0' > "$directory/home/.config/rosewm/system_terminal"
+
+# Configure screen capture checker, if needed.
+# Note: Checker's command line is split into words intentionally.
+screencopy=${ROSE_BENCH_SCREENCOPY:-}
+if [ -n "$screencopy" ]; then
+    # shellcheck disable=SC2086
+    printf '%s\0' $screencopy "$directory/screencopy.json" \
+        > "$directory/home/.config/rosewm/dispatcher"
+fi
+
+# Start the Compositor.
+HOME="$directory/home" \
+XDG_RUNTIME_DIR="$directory/runtime" \
+WLR_BACKENDS=headless \
+WLR_RENDERER="$wlr_renderer" \
+ROSE_SOFTWARE_COMPOSITION="$software_composition" \
+WLR_HEADLESS_OUTPUTS=1 \
+ROSE_BENCHMARK_REPORT="$directory/compositor.json" \
+    "$compositor" &
+
+pid=$!
+
+# Wait for Compositor's socket.
+for i in $(seq 50); do
+    if [ -S "$directory/runtime/wayland-0" ]; then
+        break
+    fi
+
+    sleep 0.1
+done
+
+if [ ! -S "$directory/runtime/wayland-0" ]; then
+    echo "run.sh: the compositor has not started" >&2
+    exit 1
+fi
+
+# Run the load generator.
+XDG_RUNTIME_DIR="$directory/runtime" \
+WAYLAND_DISPLAY=wayland-0 \
+    "$load_generator" "$@" > "$directory/load_generator.json"
+
+# Wait until screen capture checker writes its report, if needed.
+if [ -n "$screencopy" ]; then
+    for i in $(seq 100); do
+        if grep -q '"is_passed"' "$directory/screencopy.json" 2>/dev/null; then
+            break
+        fi
+
+        sleep 0.1
+    done
+
+    if [ ! -f "$directory/screencopy.json" ]; then
+        echo '{"is_passed": false}' > "$directory/screencopy.json"
+    fi
+fi
+
+# Stop the Compositor, and wait until it writes its report.
+kill -TERM "$pid"
+wait "$pid" || true
+pid=
+
+# Write the combined report.
+{
+    printf '{"renderer": "%s",\n' "$renderer"
+    printf '"load_generator":\n'
+    cat "$directory/load_generator.json"
+    printf ',\n"compositor":\n'
+    cat "$directory/compositor.json"
+    if [ -n "$screencopy" ]; then
+        printf ',\n"screencopy":\n'
+        cat "$directory/screencopy.json"
+    fi
+    printf '}\n'
+} > "$report"
+
+echo "run.sh: report has been written to $report"
+
+# Fail if the screen capture check has failed.
+if [ -n "$screencopy" ] &&
+   ! grep -q '"is_passed": true' "$directory/screencopy.json"; then
+    echo "run.sh: screen capture check has failed" >&2
+    exit 1
+fi
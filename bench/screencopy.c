@@ -0,0 +1,745 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+// Screen capture checker: captures frames of the first output with
+// wlr-screencopy's copy_with_damage request, and checks that reported damage
+// matches the "rect" damage pattern of the load generator, which runs a single
+// client. When finished, writes its report in JSON format to the given file.
+//
+// Since screen capture protocols are privileged, the checker must be started
+// as Compositor's DISPATCHER system process. In this mode it requests the
+// Compositor to start another instance of itself in capture mode (with access
+// to the privileged protocols), and waits until the Compositor terminates.
+//
+#include "wlr-screencopy-unstable-v1-client-protocol.h"
+#include <wayland-client.h>
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Helper macros.
+////////////////////////////////////////////////////////////////////////////////
+
+#define unused_(x) ((void)(x))
+
+#define min_(a, b) (((a) < (b)) ? (a) : (b))
+#define max_(a, b) (((a) > (b)) ? (a) : (b))
+
+////////////////////////////////////////////////////////////////////////////////
+// Parameters definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    // Maximum number of captured frames.
+    rose_bench_frame_count_max = 1024,
+
+    // Maximum number of client's commits which can be presented in a single
+    // frame of the output.
+    rose_bench_coalesced_commit_count_max = 4,
+
+    // Movement of load generator's square per commit.
+    rose_bench_square_step_x = 8,
+    rose_bench_square_step_y = 5
+};
+
+struct rose_bench_parameters {
+    // Path to the report file.
+    char const* report_path;
+
+    // Size of the damaged square of the load generator.
+    int damage_size;
+
+    // Number of captured frames, and the delay before the first capture (in
+    // milliseconds).
+    int frame_count, delay;
+
+    // Flag: indicates that the program runs in capture mode.
+    bool is_capture_mode;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Capture context definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_bench_rectangle {
+    int x, y, width, height;
+};
+
+struct rose_bench_frame {
+    // Bounding box of the reported damage.
+    struct rose_bench_rectangle damage;
+
+    // Flags.
+    bool is_ready, is_failed, has_damage;
+};
+
+struct rose_bench_context {
+    // Wayland objects.
+    struct wl_display* display;
+    struct wl_registry* registry;
+
+    struct wl_shm* shm;
+    struct wl_output* output;
+    struct zwlr_screencopy_manager_v1* manager;
+
+    // Version of the bound screencopy manager.
+    uint32_t manager_version;
+
+    // Buffer which receives frame's content, its parameters, and the memory
+    // region which contains its pixels.
+    struct wl_buffer* buffer;
+    uint32_t format, width, height, stride;
+
+    void* memory;
+    size_t memory_size;
+
+    // Parameters of the buffer which have been requested for the current
+    // frame.
+    uint32_t requested_format, requested_width, requested_height,
+        requested_stride;
+
+    // Captured frames.
+    struct rose_bench_frame frames[rose_bench_frame_count_max];
+    int frame_count;
+
+    // Flags.
+    bool has_buffer_parameters, is_buffer_enumeration_done;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static int
+rose_bench_create_shm_file(size_t size) {
+    // Generate a unique name.
+    char name[64] = {};
+    snprintf(
+        name, sizeof(name), "/rose-bench-screencopy-%ld", (long)(getpid()));
+
+    // Create a new shared memory object and unlink it immediately.
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(fd == -1) {
+        return fd;
+    } else {
+        shm_unlink(name);
+    }
+
+    // Set its size.
+    if(ftruncate(fd, (off_t)(size)) == -1) {
+        return (close(fd), -1);
+    }
+
+    return fd;
+}
+
+static void
+rose_bench_sleep(int milliseconds) {
+    struct timespec duration = {
+        .tv_sec = milliseconds / 1000,
+        .tv_nsec = (long)(milliseconds % 1000) * 1000000};
+
+    nanosleep(&duration, NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Event handlers.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_bench_handle_frame_buffer(
+    void* data, struct zwlr_screencopy_frame_v1* frame, uint32_t format,
+    uint32_t width, uint32_t height, uint32_t stride) {
+    unused_(frame);
+
+    // Obtain the context.
+    struct rose_bench_context* context = data;
+
+    // Save requested parameters.
+    context->requested_format = format;
+    context->requested_width = width;
+    context->requested_height = height;
+    context->requested_stride = stride;
+
+    context->has_buffer_parameters = true;
+
+    // Note: Objects of version 2 or lower do not send buffer_done event.
+    if(context->manager_version < 3) {
+        context->is_buffer_enumeration_done = true;
+    }
+}
+
+static void
+rose_bench_handle_frame_flags(
+    void* data, struct zwlr_screencopy_frame_v1* frame, uint32_t flags) {
+    unused_(data), unused_(frame), unused_(flags);
+}
+
+static void
+rose_bench_handle_frame_ready(
+    void* data, struct zwlr_screencopy_frame_v1* frame, uint32_t tv_sec_hi,
+    uint32_t tv_sec_lo, uint32_t tv_nsec) {
+    unused_(frame), unused_(tv_sec_hi), unused_(tv_sec_lo), unused_(tv_nsec);
+
+    // Obtain the context.
+    struct rose_bench_context* context = data;
+
+    // Mark current frame as ready.
+    context->frames[context->frame_count].is_ready = true;
+}
+
+static void
+rose_bench_handle_frame_failed(
+    void* data, struct zwlr_screencopy_frame_v1* frame) {
+    unused_(frame);
+
+    // Obtain the context.
+    struct rose_bench_context* context = data;
+
+    // Mark current frame as failed.
+    context->frames[context->frame_count].is_failed = true;
+}
+
+static void
+rose_bench_handle_frame_damage(
+    void* data, struct zwlr_screencopy_frame_v1* frame, uint32_t x, uint32_t y,
+    uint32_t width, uint32_t height) {
+    unused_(frame);
+
+    // Obtain the context and current frame.
+    struct rose_bench_context* context = data;
+    struct rose_bench_frame* current = &(context->frames[context->frame_count]);
+
+    // Add the damage to frame's bounding box.
+    struct rose_bench_rectangle damage = {
+        .x = (int)(x), .y = (int)(y), .width = (int)(width),
+        .height = (int)(height)};
+
+    if(current->has_damage) {
+        int x1 = min_(current->damage.x, damage.x);
+        int y1 = min_(current->damage.y, damage.y);
+        int x2 = max_(
+            current->damage.x + current->damage.width, damage.x + damage.width);
+        int y2 = max_(
+            current->damage.y + current->damage.height,
+            damage.y + damage.height);
+
+        damage = (struct rose_bench_rectangle){
+            .x = x1, .y = y1, .width = x2 - x1, .height = y2 - y1};
+    }
+
+    current->damage = damage;
+    current->has_damage = true;
+}
+
+static void
+rose_bench_handle_frame_linux_dmabuf(
+    void* data, struct zwlr_screencopy_frame_v1* frame, uint32_t format,
+    uint32_t width, uint32_t height) {
+    unused_(data), unused_(frame), unused_(format), unused_(width),
+        unused_(height);
+}
+
+static void
+rose_bench_handle_frame_buffer_done(
+    void* data, struct zwlr_screencopy_frame_v1* frame) {
+    unused_(frame);
+    ((struct rose_bench_context*)(data))->is_buffer_enumeration_done = true;
+}
+
+static struct zwlr_screencopy_frame_v1_listener const
+    rose_bench_frame_listener = {
+        .buffer = rose_bench_handle_frame_buffer,
+        .flags = rose_bench_handle_frame_flags,
+        .ready = rose_bench_handle_frame_ready,
+        .failed = rose_bench_handle_frame_failed,
+        .damage = rose_bench_handle_frame_damage,
+        .linux_dmabuf = rose_bench_handle_frame_linux_dmabuf,
+        .buffer_done = rose_bench_handle_frame_buffer_done};
+
+static void
+rose_bench_handle_registry_global(
+    void* data, struct wl_registry* registry, uint32_t name,
+    char const* interface, uint32_t version) {
+    // Obtain the context.
+    struct rose_bench_context* context = data;
+
+    // Bind required globals.
+    if(strcmp(interface, wl_shm_interface.name) == 0) {
+        context->shm = wl_registry_bind(registry, name, &wl_shm_interface, 1);
+    } else if(
+        (strcmp(interface, wl_output_interface.name) == 0) &&
+        (context->output == NULL)) {
+        context->output =
+            wl_registry_bind(registry, name, &wl_output_interface, 1);
+    } else if(
+        (strcmp(interface, zwlr_screencopy_manager_v1_interface.name) == 0) &&
+        (version >= 2)) {
+        context->manager_version = min_(version, 3);
+        context->manager = wl_registry_bind(
+            registry, name, &zwlr_screencopy_manager_v1_interface,
+            context->manager_version);
+    }
+}
+
+static void
+rose_bench_handle_registry_global_remove(
+    void* data, struct wl_registry* registry, uint32_t name) {
+    unused_(data), unused_(registry), unused_(name);
+}
+
+static struct wl_registry_listener const rose_bench_registry_listener = {
+    .global = rose_bench_handle_registry_global,
+    .global_remove = rose_bench_handle_registry_global_remove};
+
+////////////////////////////////////////////////////////////////////////////////
+// Buffer manipulation utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_bench_context_destroy_buffer(struct rose_bench_context* context) {
+    if(context->buffer != NULL) {
+        wl_buffer_destroy(context->buffer);
+    }
+
+    if(context->memory != NULL) {
+        munmap(context->memory, context->memory_size);
+    }
+
+    context->buffer = NULL;
+    context->memory = NULL;
+    context->memory_size = 0;
+}
+
+static bool
+rose_bench_context_prepare_buffer(struct rose_bench_context* context) {
+    // Do nothing if current buffer has requested parameters.
+    if((context->buffer != NULL) &&
+       (context->format == context->requested_format) &&
+       (context->width == context->requested_width) &&
+       (context->height == context->requested_height) &&
+       (context->stride == context->requested_stride)) {
+        return true;
+    }
+
+    // Destroy previous buffer.
+    rose_bench_context_destroy_buffer(context);
+
+    // Create and map shared memory.
+    size_t memory_size = (size_t)(context->requested_stride) *
+                         (size_t)(context->requested_height);
+
+    int fd = rose_bench_create_shm_file(memory_size);
+    if(fd == -1) {
+        return false;
+    }
+
+    void* memory =
+        mmap(NULL, memory_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if(memory == MAP_FAILED) {
+        return (close(fd), false);
+    }
+
+    context->memory = memory;
+    context->memory_size = memory_size;
+
+    // Create the buffer.
+    struct wl_shm_pool* pool =
+        wl_shm_create_pool(context->shm, fd, (int32_t)(memory_size));
+
+    context->buffer = wl_shm_pool_create_buffer(
+        pool, 0, (int32_t)(context->requested_width),
+        (int32_t)(context->requested_height),
+        (int32_t)(context->requested_stride), context->requested_format);
+
+    wl_shm_pool_destroy(pool);
+    close(fd);
+
+    // Save buffer's parameters.
+    context->format = context->requested_format;
+    context->width = context->requested_width;
+    context->height = context->requested_height;
+    context->stride = context->requested_stride;
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Capture utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool
+rose_bench_capture_frame(struct rose_bench_context* context) {
+    // Request a new frame.
+    struct zwlr_screencopy_frame_v1* frame =
+        zwlr_screencopy_manager_v1_capture_output(
+            context->manager, 0, context->output);
+
+    zwlr_screencopy_frame_v1_add_listener(
+        frame, &rose_bench_frame_listener, context);
+
+    // Wait until all supported buffer types are reported.
+    context->has_buffer_parameters = false;
+    context->is_buffer_enumeration_done = false;
+
+    struct rose_bench_frame* current = &(context->frames[context->frame_count]);
+    *current = (struct rose_bench_frame){};
+
+    while(!(context->is_buffer_enumeration_done) && !(current->is_failed)) {
+        if(wl_display_dispatch(context->display) == -1) {
+            return (zwlr_screencopy_frame_v1_destroy(frame), false);
+        }
+    }
+
+    // Copy the frame when it is damaged.
+    if(!(current->is_failed)) {
+        if(!(context->has_buffer_parameters) ||
+           !rose_bench_context_prepare_buffer(context)) {
+            return (zwlr_screencopy_frame_v1_destroy(frame), false);
+        }
+
+        zwlr_screencopy_frame_v1_copy_with_damage(frame, context->buffer);
+    }
+
+    // Wait until the frame is copied.
+    while(!(current->is_ready) && !(current->is_failed)) {
+        if(wl_display_dispatch(context->display) == -1) {
+            return (zwlr_screencopy_frame_v1_destroy(frame), false);
+        }
+    }
+
+    // Destroy the frame, and save it.
+    zwlr_screencopy_frame_v1_destroy(frame);
+    context->frame_count++;
+
+    return true;
+}
+
+static bool
+rose_bench_frame_matches_pattern(
+    struct rose_bench_frame const* frame, int damage_size) {
+    // Note: Each commit of load generator's client damages two squares: the
+    // previous one, and the one which is moved by a fixed step. Commits which
+    // are presented in the same frame add up to a larger bounding box.
+    int n = rose_bench_coalesced_commit_count_max;
+
+    return frame->has_damage && (frame->damage.width > 0) &&
+           (frame->damage.height > 0) &&
+           (frame->damage.width <=
+            (damage_size + rose_bench_square_step_x * n)) &&
+           (frame->damage.height <=
+            (damage_size + rose_bench_square_step_y * n));
+}
+
+static bool
+rose_bench_write_report(
+    struct rose_bench_context const* context,
+    struct rose_bench_parameters const* parameters, bool is_capture_complete) {
+    // Count the frames.
+    int failed_count = 0, full_damage_count = 0, matched_count = 0;
+    for(int i = 0; i != context->frame_count; ++i) {
+        struct rose_bench_frame const* frame = &(context->frames[i]);
+
+        if(frame->is_failed) {
+            failed_count++;
+            continue;
+        }
+
+        if(!(frame->has_damage) ||
+           (((uint32_t)(frame->damage.width) >= context->width) &&
+            ((uint32_t)(frame->damage.height) >= context->height))) {
+            full_damage_count++;
+        }
+
+        if(rose_bench_frame_matches_pattern(frame, parameters->damage_size)) {
+            matched_count++;
+        }
+    }
+
+    // The check passes if all frames have been copied, none of them has been
+    // fully damaged, and the damage of at least 90% of the frames matches the
+    // pattern.
+    // Note: The remaining frames are the ones in which load generator's square
+    // wraps around the edge of its buffer.
+    bool is_passed = is_capture_complete && (context->frame_count != 0) &&
+                     (failed_count == 0) && (full_damage_count == 0) &&
+                     ((matched_count * 10) >= (context->frame_count * 9));
+
+    // Write the report.
+    FILE* file = fopen(parameters->report_path, "w");
+    if(file == NULL) {
+        return false;
+    }
+
+    fprintf(
+        file,
+        "{\"frame_count\": %d, \"failed_count\": %d, "
+        "\"full_damage_count\": %d, \"matched_count\": %d,\n"
+        " \"damage\": [",
+        context->frame_count, failed_count, full_damage_count, matched_count);
+
+    for(int i = 0; i != context->frame_count; ++i) {
+        struct rose_bench_rectangle damage = context->frames[i].damage;
+        fprintf(
+            file, "%s[%d, %d, %d, %d]", ((i == 0) ? "" : ", "), damage.x,
+            damage.y, damage.width, damage.height);
+    }
+
+    fprintf(file, "],\n \"is_passed\": %s}\n", (is_passed ? "true" : "false"));
+    fclose(file);
+
+    return is_passed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Program modes.
+////////////////////////////////////////////////////////////////////////////////
+
+static int
+rose_bench_run_capture_mode(struct rose_bench_parameters const* parameters) {
+    // Initialize the context.
+    struct rose_bench_context* context =
+        calloc(1, sizeof(struct rose_bench_context));
+
+    if(context == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    // Connect to the compositor, and obtain required globals.
+    bool is_capture_complete = false;
+    if((context->display = wl_display_connect(NULL)) == NULL) {
+        goto end;
+    }
+
+    context->registry = wl_display_get_registry(context->display);
+    wl_registry_add_listener(
+        context->registry, &rose_bench_registry_listener, context);
+
+    if((wl_display_roundtrip(context->display) == -1) ||
+       (context->shm == NULL) || (context->output == NULL) ||
+       (context->manager == NULL)) {
+        goto end;
+    }
+
+    // Wait until load generator's client starts committing its frames.
+    rose_bench_sleep(parameters->delay);
+
+    // Capture the frames.
+    // Note: The first frame is not checked, since it contains the damage which
+    // has been accumulated before the capture started.
+    if(!rose_bench_capture_frame(context)) {
+        goto end;
+    }
+
+    context->frame_count = 0;
+    for(int i = 0; i != parameters->frame_count; ++i) {
+        if(!rose_bench_capture_frame(context)) {
+            goto end;
+        }
+    }
+
+    is_capture_complete = true;
+
+end:;
+
+    // Write the report.
+    bool is_passed =
+        rose_bench_write_report(context, parameters, is_capture_complete);
+
+    // Destroy the context.
+    rose_bench_context_destroy_buffer(context);
+
+#define destroy_(type, x)          \
+    if(context->x != NULL) {       \
+        type##_destroy(context->x); \
+    }
+
+    destroy_(zwlr_screencopy_manager_v1, manager);
+    destroy_(wl_output, output);
+    destroy_(wl_shm, shm);
+    destroy_(wl_registry, registry);
+
+#undef destroy_
+
+    if(context->display != NULL) {
+        wl_display_disconnect(context->display);
+    }
+
+    free(context);
+
+    return (is_passed ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+static bool
+rose_bench_write_all(int fd, unsigned char const* data, size_t size) {
+    while(size != 0) {
+        ssize_t n = write(fd, data, size);
+        if(n <= 0) {
+            return false;
+        }
+
+        data += n, size -= (size_t)(n);
+    }
+
+    return true;
+}
+
+static int
+rose_bench_run_dispatcher_mode(int argc, char* argv[]) {
+    // Obtain the path to this program.
+    char path[PATH_MAX] = {};
+    if(readlink("/proc/self/exe", path, sizeof(path) - 1) <= 0) {
+        return EXIT_FAILURE;
+    }
+
+    // Construct a DISPATCHER packet which starts this program in capture mode
+    // with access to the privileged Wayland protocols.
+    // Note: Packet's payload consists of access rights, followed by
+    // null-character-terminated command line arguments.
+    unsigned char packet[4096] = {};
+    size_t size = 2;
+
+    packet[size++] = 0x02;
+
+#define add_(string)                        \
+    {                                       \
+        size_t n = strlen(string) + 1;      \
+        if((size + n) > sizeof(packet)) {   \
+            return EXIT_FAILURE;            \
+        }                                   \
+                                            \
+        memcpy(packet + size, (string), n); \
+        size += n;                          \
+    }
+
+    add_(path);
+    add_("-c");
+    for(int i = 1; i < argc; ++i) {
+        add_(argv[i]);
+    }
+
+#undef add_
+
+    // Write packet's header (payload's size in little-endian byte order).
+    packet[0] = (unsigned char)((size - 2) & 0xFF);
+    packet[1] = (unsigned char)(((size - 2) >> 8) & 0xFF);
+
+    // Connect to Compositor's IPC endpoint.
+    char const* endpoint = getenv("ROSE_IPC_ENDPOINT");
+    if((endpoint == NULL) ||
+       (strlen(endpoint) >= sizeof(((struct sockaddr_un*)(NULL))->sun_path))) {
+        return EXIT_FAILURE;
+    }
+
+    struct sockaddr_un address = {.sun_family = AF_UNIX};
+    strcpy(address.sun_path, endpoint);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if((fd == -1) ||
+       (connect(fd, (struct sockaddr*)(&address), sizeof(address)) == -1)) {
+        return EXIT_FAILURE;
+    }
+
+    // Select DISPATCHER protocol variant, and send the packet.
+    unsigned char const selection[] = {0x01, 0x00, 0x02};
+    if(!rose_bench_write_all(fd, selection, sizeof(selection)) ||
+       !rose_bench_write_all(fd, packet, size)) {
+        return (close(fd), EXIT_FAILURE);
+    }
+
+    // Wait until the Compositor closes the connection.
+    // Note: If the DISPATCHER terminates, then the Compositor restarts it,
+    // which would start another capture.
+    unsigned char buffer[256] = {};
+    while(read(fd, buffer, sizeof(buffer)) > 0) {
+        continue;
+    }
+
+    return (close(fd), EXIT_SUCCESS);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Parameter parsing utility function.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool
+rose_bench_parse_parameters(
+    int argc, char* argv[], struct rose_bench_parameters* parameters) {
+    // Initialize default parameters.
+    *parameters = (struct rose_bench_parameters){
+        .damage_size = 64, .frame_count = 60, .delay = 2000};
+
+    // Parse the options.
+    for(int option = 0; (option = getopt(argc, argv, "D:n:w:c")) != -1;) {
+        switch(option) {
+            case 'D':
+                parameters->damage_size = atoi(optarg);
+                break;
+
+            case 'n':
+                parameters->frame_count = atoi(optarg);
+                break;
+
+            case 'w':
+                parameters->delay = atoi(optarg);
+                break;
+
+            case 'c':
+                parameters->is_capture_mode = true;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    // Obtain the path to the report file.
+    if(optind != (argc - 1)) {
+        return false;
+    }
+
+    parameters->report_path = argv[optind];
+
+    // Validate the parameters.
+    return (parameters->damage_size > 0) && (parameters->frame_count > 0) &&
+           (parameters->frame_count <= rose_bench_frame_count_max) &&
+           (parameters->delay >= 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Program entry point.
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(int argc, char* argv[]) {
+    // Parse the parameters.
+    struct rose_bench_parameters parameters = {};
+    if(!rose_bench_parse_parameters(argc, argv, &parameters)) {
+        fprintf(
+            stderr,
+            "usage: %s [-D damage size] [-n frames] [-w delay in ms] REPORT\n",
+            argv[0]);
+
+        return EXIT_FAILURE;
+    }
+
+    // Run the program in the requested mode.
+    return (parameters.is_capture_mode
+                ? rose_bench_run_capture_mode(&parameters)
+                : rose_bench_run_dispatcher_mode(argc, argv));
+}
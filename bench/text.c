@@ -0,0 +1,325 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+// Text rendering benchmark: measures the throughput of string conversion,
+// string extent computation, and string rendering over a corpus of window
+// titles, for several font sizes and DPIs.
+//
+// Usage: bench_text FONT_FILE [FONT_FILE...]
+//
+// Font files are used in the given order (subsequent fonts are fallbacks).
+//
+#include "memory.h"
+#include "rendering_text.h"
+#include "unicode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark parameters.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    // Maximum number of fonts.
+    rose_bench_font_count_max = 8,
+
+    // Pixel buffer's size.
+    rose_bench_pixel_buffer_width = 800,
+    rose_bench_pixel_buffer_height = 128,
+
+    // Minimum duration of each measurement (in nanoseconds).
+    rose_bench_duration_min = 200000000
+};
+
+static int const rose_bench_font_sizes[] = {10, 14, 20};
+static int const rose_bench_dpis[] = {96, 144, 192};
+
+////////////////////////////////////////////////////////////////////////////////
+// Corpus.
+////////////////////////////////////////////////////////////////////////////////
+
+enum { rose_bench_corpus_size_max = 8 };
+
+struct rose_bench_corpus {
+    char const* name;
+    char const* titles[rose_bench_corpus_size_max];
+};
+
+static struct rose_bench_corpus const rose_bench_corpora[] = {
+    {.name = "ascii",
+     .titles =
+         {"vim src/rendering_text.c",
+          "Inbox (3) - user@example.com - Mail",
+          "htop",
+          "make -j16 bench - Terminal",
+          "GitHub - everard/rosewm: Rose WM - Mozilla Firefox"}},
+    {.name = "rtl",
+     .titles =
+         {"مرحبا بالعالم - Mozilla Firefox",
+          "שלום עולם - README.md",
+          "Report: تقرير الربع الثالث.pdf (page 3 of 12)",
+          "מסמך ללא שם 1 - LibreOffice Writer"}},
+    {.name = "cjk",
+     .titles =
+         {"日本語のテキスト - メモ帳",
+          "中文维基百科 - 维基百科，自由的百科全书",
+          "한국어 문서 편집기",
+          "東京都の天気予報 - Chromium"}},
+    {.name = "emoji",
+     .titles =
+         {"🎉 Release party 🎂 - Chat",
+          "Music ♫ 🎵 Now playing: Track 7",
+          "✅ Tasks - 🔥 urgent (4)",
+          "😀😁😂🤣 reactions - Messenger"}},
+    {.name = "long",
+     .titles =
+         {"A very long document title which certainly does not fit into the "
+          "panel, since it contains a lot of words and goes on and on and on, "
+          "well past the maximum size of a string - LibreOffice Writer",
+          "~/projects/rosewm/src/rendering_text.c (modified) - "
+          "~/projects/rosewm/src/rendering_glyph_atlas.c - "
+          "~/projects/rosewm/src/device_output.c - Visual Studio Code - "
+          "Insiders Edition",
+          "東京都の天気予報、週間天気、雨雲レーダー、"
+          "警報・注意報、台風情報、地震情報、"
+          "花粉情報、熱中症情報、紫外線情報、"
+          "洗濯指数、服装指数、星空指数、"
+          "傘指数、体感温度、風向風速、"
+          "日の出日の入り時刻、月齢、潮汐、"
+          "週末の天気、二週間天気 - "
+          "天気予報サイト - Mozilla Firefox"}}};
+
+////////////////////////////////////////////////////////////////////////////////
+// Operation definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_bench_operation {
+    rose_bench_operation_convert,
+    rose_bench_operation_extent,
+    rose_bench_operation_render,
+    rose_bench_operation_count_
+};
+
+static char const* const rose_bench_operation_names[] = {
+    [rose_bench_operation_convert] = "convert",
+    [rose_bench_operation_extent] = "extent",
+    [rose_bench_operation_render] = "render"};
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static double
+rose_bench_time_now(void) {
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)(ts.tv_sec) * 1.0e9 + (double)(ts.tv_nsec);
+}
+
+static struct rose_memory
+rose_bench_read_file(char const* file_path) {
+    // Open the file.
+    FILE* file = fopen(file_path, "rb");
+    if(file == NULL) {
+        return (struct rose_memory){};
+    }
+
+    // Obtain its size, and read its contents.
+    struct rose_memory memory = {};
+    if(fseek(file, 0, SEEK_END) == 0) {
+        long size = ftell(file);
+
+        if((size > 0) && (fseek(file, 0, SEEK_SET) == 0)) {
+            memory = rose_allocate((size_t)(size));
+
+            if((memory.data != NULL) &&
+               (fread(memory.data, memory.size, 1, file) != 1)) {
+                rose_free(&memory);
+            }
+        }
+    }
+
+    return (fclose(file), memory);
+}
+
+static size_t
+rose_bench_process_string(
+    struct rose_text_rendering_context* context,
+    struct rose_text_rendering_parameters parameters,
+    struct rose_pixel_buffer pixel_buffer, enum rose_bench_operation operation,
+    char const* title, struct rose_utf32_string const* string) {
+    switch(operation) {
+        case rose_bench_operation_convert:
+            return rose_convert_utf8_to_utf32(
+                       rose_convert_ntbs_to_utf8((char*)(title)))
+                .size;
+
+        case rose_bench_operation_extent:
+            rose_compute_string_extent(context, parameters, *string);
+            return string->size;
+
+        case rose_bench_operation_render:
+            rose_render_string(context, parameters, *string, pixel_buffer);
+            return string->size;
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Program entry point.
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(int argc, char* argv[]) {
+    // Read the fonts.
+    if((argc < 2) || (argc > (rose_bench_font_count_max + 1))) {
+        fprintf(stderr, "usage: %s FONT_FILE [FONT_FILE...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    struct rose_memory fonts[rose_bench_font_count_max] = {};
+    size_t font_count = 0;
+
+    for(int i = 1; i != argc; ++i) {
+        fonts[font_count] = rose_bench_read_file(argv[i]);
+
+        if(fonts[font_count].data == NULL) {
+            fprintf(stderr, "unable to read %s\n", argv[i]);
+        } else {
+            font_count++;
+        }
+    }
+
+    // Initialize text rendering context.
+    struct rose_text_rendering_context* context =
+        rose_text_rendering_context_initialize(
+            (struct rose_text_rendering_context_parameters){
+                .fonts = fonts, .font_count = font_count});
+
+    if(context == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    // Allocate pixel buffer.
+    struct rose_pixel_buffer pixel_buffer = {
+        .data = calloc(
+            4 * rose_bench_pixel_buffer_width, rose_bench_pixel_buffer_height),
+        .width = rose_bench_pixel_buffer_width,
+        .height = rose_bench_pixel_buffer_height,
+        .pitch = 4 * rose_bench_pixel_buffer_width};
+
+    if(pixel_buffer.data == NULL) {
+        return (rose_text_rendering_context_destroy(context), EXIT_FAILURE);
+    }
+
+    // Convert the corpus.
+    size_t const corpus_count =
+        sizeof(rose_bench_corpora) / sizeof(rose_bench_corpora[0]);
+
+    static struct rose_utf32_string strings[sizeof(rose_bench_corpora) /
+                                            sizeof(rose_bench_corpora[0])]
+                                           [rose_bench_corpus_size_max];
+
+    for(size_t i = 0; i != corpus_count; ++i) {
+        for(size_t j = 0; rose_bench_corpora[i].titles[j] != NULL; ++j) {
+            strings[i][j] =
+                rose_convert_utf8_to_utf32(rose_convert_ntbs_to_utf8(
+                    (char*)(rose_bench_corpora[i].titles[j])));
+        }
+    }
+
+    // Run the benchmark for each font size and DPI.
+    for(size_t i = 0; i != (sizeof(rose_bench_font_sizes) / sizeof(int)); ++i) {
+        for(size_t j = 0; j != (sizeof(rose_bench_dpis) / sizeof(int)); ++j) {
+            struct rose_text_rendering_parameters parameters = {
+                .font_size = rose_bench_font_sizes[i],
+                .dpi = rose_bench_dpis[j],
+                .color = {.rgba8 = {255, 255, 255, 255}}};
+
+            // Limit pixel buffer's height to the height of a panel.
+            struct rose_pixel_buffer target = pixel_buffer;
+            target.height = (parameters.font_size * parameters.dpi) / 36;
+            if(target.height > rose_bench_pixel_buffer_height) {
+                target.height = rose_bench_pixel_buffer_height;
+            }
+
+            // Benchmark each operation on each corpus.
+            for(int operation = 0; operation != rose_bench_operation_count_;
+                ++operation) {
+                for(size_t k = 0; k != corpus_count; ++k) {
+                    struct rose_bench_corpus const* corpus =
+                        &(rose_bench_corpora[k]);
+
+                    // Warm-up the glyph cache, save its statistics.
+                    for(size_t l = 0; corpus->titles[l] != NULL; ++l) {
+                        rose_bench_process_string(
+                            context, parameters, target,
+                            (enum rose_bench_operation)(operation),
+                            corpus->titles[l], &(strings[k][l]));
+                    }
+
+                    struct rose_text_rendering_statistics statistics =
+                        rose_text_rendering_statistics_obtain(context);
+
+                    // Measure operation's performance.
+                    size_t n_strings = 0, n_glyphs = 0;
+
+                    double t0 = rose_bench_time_now(), t1 = t0;
+                    while((t1 - t0) < rose_bench_duration_min) {
+                        for(size_t l = 0; corpus->titles[l] != NULL; ++l) {
+                            n_glyphs += rose_bench_process_string(
+                                context, parameters, target,
+                                (enum rose_bench_operation)(operation),
+                                corpus->titles[l], &(strings[k][l]));
+
+                            n_strings++;
+                        }
+
+                        t1 = rose_bench_time_now();
+                    }
+
+                    // Compute glyph cache's miss rate during the measurement.
+                    struct rose_text_rendering_statistics current =
+                        rose_text_rendering_statistics_obtain(context);
+
+                    size_t n_hits = current.glyph_cache_hit_count -
+                                    statistics.glyph_cache_hit_count;
+
+                    size_t n_misses = current.glyph_cache_miss_count -
+                                      statistics.glyph_cache_miss_count;
+
+                    double miss_rate =
+                        (((n_hits + n_misses) == 0)
+                             ? 0.0
+                             : (100.0 * (double)(n_misses) /
+                                (double)(n_hits + n_misses)));
+
+                    // Print the results.
+                    printf(
+                        "%-7s  size=%2d  dpi=%3d  %-5s  %9.1f ns/string  "
+                        "%8.3f Mglyphs/s  %5.1f%% cache misses\n",
+                        rose_bench_operation_names[operation],
+                        parameters.font_size, parameters.dpi, corpus->name,
+                        (t1 - t0) / (double)(n_strings),
+                        1.0e3 * (double)(n_glyphs) / (t1 - t0), miss_rate);
+                }
+            }
+        }
+    }
+
+    // Free memory.
+    free(pixel_buffer.data);
+    rose_text_rendering_context_destroy(context);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,304 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "benchmark.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Helper macros.
+////////////////////////////////////////////////////////////////////////////////
+
+#define max_(a, b) (((a) > (b)) ? (a) : (b))
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    // Maximum number of recorded frames.
+    rose_benchmark_frame_count_max = 1 << 20,
+
+    // Maximum number of outputs which are tracked.
+    rose_benchmark_output_count_max = 16
+};
+
+struct rose_benchmark_output {
+    // Output's ID.
+    unsigned id;
+
+    // Number of frames of each type.
+    uint64_t frame_counts[rose_benchmark_frame_type_count_];
+
+    // Number of frames which have been counted, but not recorded.
+    uint64_t unrecorded_frame_count;
+
+    // Total CPU time and total damage area of rendered frames.
+    uint64_t cpu_time_total, damage_area_total;
+};
+
+struct rose_benchmark {
+    // Path to the report file.
+    char* report_file_path;
+
+    // Benchmark's start time (in nanoseconds).
+    uint64_t start_time;
+
+    // Tracked outputs.
+    struct rose_benchmark_output outputs[rose_benchmark_output_count_max];
+    size_t output_count;
+
+    // Recorded frames.
+    struct rose_benchmark_frame* frames;
+    size_t frame_count, frame_capacity;
+};
+
+static char const* const rose_benchmark_frame_type_names[] = {
+    [rose_benchmark_frame_type_rendered] = "rendered",
+    [rose_benchmark_frame_type_scanned_out] = "scanned_out",
+    [rose_benchmark_frame_type_skipped] = "skipped"};
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static struct rose_benchmark_output*
+rose_benchmark_output_obtain(struct rose_benchmark* benchmark, unsigned id) {
+    // Find the output with the given ID.
+    for(size_t i = 0; i != benchmark->output_count; ++i) {
+        if(benchmark->outputs[i].id == id) {
+            return &(benchmark->outputs[i]);
+        }
+    }
+
+    // If there is no such output, then start tracking it, if possible.
+    if(benchmark->output_count == rose_benchmark_output_count_max) {
+        return NULL;
+    }
+
+    struct rose_benchmark_output* output =
+        &(benchmark->outputs[benchmark->output_count++]);
+
+    return (*output = (struct rose_benchmark_output){.id = id}), output;
+}
+
+static bool
+rose_benchmark_frame_is_rendered(struct rose_benchmark_frame const* frame) {
+    return (frame->type != rose_benchmark_frame_type_skipped);
+}
+
+static int
+rose_benchmark_compare_uint64(void const* a, void const* b) {
+    uint64_t x = *((uint64_t const*)(a)), y = *((uint64_t const*)(b));
+    return ((x > y) - (x < y));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Report writing utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_benchmark_write_output(
+    struct rose_benchmark* benchmark, struct rose_benchmark_output* output,
+    uint64_t* cpu_times, FILE* file) {
+    // Obtain CPU times of output's rendered frames, and sort them.
+    size_t n = 0;
+    for(size_t i = 0; i != benchmark->frame_count; ++i) {
+        struct rose_benchmark_frame* frame = &(benchmark->frames[i]);
+
+        if((frame->output_id == output->id) &&
+           rose_benchmark_frame_is_rendered(frame)) {
+            cpu_times[n++] = frame->cpu_time;
+        }
+    }
+
+    qsort(cpu_times, n, sizeof(uint64_t), rose_benchmark_compare_uint64);
+
+    // Compute the number of rendered frames.
+    uint64_t rendered_frame_count =
+        output->frame_counts[rose_benchmark_frame_type_rendered] +
+        output->frame_counts[rose_benchmark_frame_type_scanned_out];
+
+    uint64_t divisor = max_(rendered_frame_count, 1);
+
+#define percentile_(p) ((n == 0) ? 0 : cpu_times[((n - 1) * (p)) / 100])
+
+    // Write output's data.
+    fprintf(
+        file,
+        "    {\"id\": %u,\n"
+        "     \"frame_count\": {\"rendered\": %" PRIu64
+        ", \"scanned_out\": %" PRIu64 ", \"skipped\": %" PRIu64 "},\n"
+        "     \"unrecorded_frame_count\": %" PRIu64 ",\n"
+        "     \"cpu_time_ns\": {\"mean\": %" PRIu64 ", \"p50\": %" PRIu64
+        ", \"p90\": %" PRIu64 ", \"p99\": %" PRIu64 ", \"max\": %" PRIu64
+        "},\n"
+        "     \"damage_area\": {\"total\": %" PRIu64 ", \"mean\": %" PRIu64
+        "}}",
+        output->id, output->frame_counts[rose_benchmark_frame_type_rendered],
+        output->frame_counts[rose_benchmark_frame_type_scanned_out],
+        output->frame_counts[rose_benchmark_frame_type_skipped],
+        output->unrecorded_frame_count, output->cpu_time_total / divisor,
+        percentile_(50), percentile_(90), percentile_(99),
+        ((n == 0) ? 0 : cpu_times[n - 1]), output->damage_area_total,
+        output->damage_area_total / divisor);
+
+#undef percentile_
+}
+
+static void
+rose_benchmark_write_report(struct rose_benchmark* benchmark) {
+    // Open the report file.
+    FILE* file = fopen(benchmark->report_file_path, "w");
+    if(file == NULL) {
+        return;
+    }
+
+    // Allocate memory for CPU times.
+    uint64_t* cpu_times =
+        malloc(sizeof(uint64_t) * max_(benchmark->frame_count, 1));
+
+    if(cpu_times == NULL) {
+        fclose(file);
+        return;
+    }
+
+    // Write outputs.
+    fprintf(file, "{\"outputs\": [\n");
+    for(size_t i = 0; i != benchmark->output_count; ++i) {
+        rose_benchmark_write_output(
+            benchmark, &(benchmark->outputs[i]), cpu_times, file);
+
+        fprintf(file, ((i + 1) == benchmark->output_count) ? "\n" : ",\n");
+    }
+
+    // Write frames.
+    fprintf(file, "  ],\n \"frames\": [\n");
+    for(size_t i = 0; i != benchmark->frame_count; ++i) {
+        struct rose_benchmark_frame* frame = &(benchmark->frames[i]);
+
+        fprintf(
+            file,
+            "    {\"output\": %u, \"type\": \"%s\", \"time_ns\": %" PRIu64
+            ", \"cpu_time_ns\": %" PRIu64 ", \"damage_area\": %" PRIu64 "}%s\n",
+            frame->output_id, rose_benchmark_frame_type_names[frame->type],
+            frame->time - benchmark->start_time, frame->cpu_time,
+            frame->damage_area,
+            (((i + 1) == benchmark->frame_count) ? "" : ","));
+    }
+
+    fprintf(file, "  ]}\n");
+
+    // Free memory and close the file.
+    free(cpu_times);
+    fclose(file);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization/destruction interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_benchmark*
+rose_benchmark_initialize(char const* report_file_path) {
+    // Allocate and initialize a new benchmark.
+    struct rose_benchmark* benchmark = malloc(sizeof(struct rose_benchmark));
+    if(benchmark == NULL) {
+        return benchmark;
+    } else {
+        *benchmark = (struct rose_benchmark){};
+    }
+
+    // Save the path to the report file.
+    benchmark->report_file_path = malloc(strlen(report_file_path) + 1);
+    if(benchmark->report_file_path == NULL) {
+        return (rose_benchmark_destroy(benchmark), NULL);
+    } else {
+        strcpy(benchmark->report_file_path, report_file_path);
+    }
+
+    // Save benchmark's start time.
+    if(true) {
+        struct timespec timestamp = {};
+        clock_gettime(CLOCK_MONOTONIC, &timestamp);
+
+        benchmark->start_time = (uint64_t)(timestamp.tv_sec) * 1000000000 +
+                                (uint64_t)(timestamp.tv_nsec);
+    }
+
+    return benchmark;
+}
+
+void
+rose_benchmark_destroy(struct rose_benchmark* benchmark) {
+    if(benchmark == NULL) {
+        return;
+    }
+
+    // Write the report.
+    if(benchmark->report_file_path != NULL) {
+        rose_benchmark_write_report(benchmark);
+    }
+
+    // Free memory.
+    free(benchmark->report_file_path);
+    free(benchmark->frames);
+    free(benchmark);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Recording interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_benchmark_record_frame(
+    struct rose_benchmark* benchmark, struct rose_benchmark_frame frame) {
+    // Obtain frame's output.
+    struct rose_benchmark_output* output =
+        rose_benchmark_output_obtain(benchmark, frame.output_id);
+
+    if(output == NULL) {
+        return;
+    }
+
+    // Update output's counters.
+    output->frame_counts[frame.type]++;
+
+    if(rose_benchmark_frame_is_rendered(&frame)) {
+        output->cpu_time_total += frame.cpu_time;
+        output->damage_area_total += frame.damage_area;
+    }
+
+    // Grow the array of frames, if needed.
+    if(benchmark->frame_count == benchmark->frame_capacity) {
+        size_t capacity = max_(2 * benchmark->frame_capacity, 4096);
+        if(capacity > rose_benchmark_frame_count_max) {
+            capacity = rose_benchmark_frame_count_max;
+        }
+
+        struct rose_benchmark_frame* frames = NULL;
+        if(capacity != benchmark->frame_capacity) {
+            frames = realloc(
+                benchmark->frames,
+                sizeof(struct rose_benchmark_frame) * capacity);
+        }
+
+        if(frames == NULL) {
+            output->unrecorded_frame_count++;
+            return;
+        }
+
+        benchmark->frames = frames;
+        benchmark->frame_capacity = capacity;
+    }
+
+    // Record the frame.
+    benchmark->frames[benchmark->frame_count++] = frame;
+}
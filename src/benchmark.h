@@ -0,0 +1,73 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_3B9D51E07A6C4F0E8D2B6A41C95F7E13
+#define H_3B9D51E07A6C4F0E8D2B6A41C95F7E13
+
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark declaration.
+// Note: Pointer to this type shall be used as an opaque handle.
+//
+// Note: Benchmark records per-frame statistics of all outputs, and writes them
+// to a report file in JSON format when it is destroyed.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_benchmark;
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_benchmark_frame_type {
+    // Output's content has been rendered.
+    rose_benchmark_frame_type_rendered,
+
+    // Output has been put in direct scan-out mode.
+    rose_benchmark_frame_type_scanned_out,
+
+    // Output's content has not been rendered.
+    rose_benchmark_frame_type_skipped,
+    rose_benchmark_frame_type_count_
+};
+
+struct rose_benchmark_frame {
+    // Output's ID.
+    unsigned output_id;
+
+    // Frame's type.
+    enum rose_benchmark_frame_type type;
+
+    // Frame's timestamp, and CPU time spent rendering the frame (in
+    // nanoseconds).
+    uint64_t time, cpu_time;
+
+    // Area of the damaged region which has been redrawn (in pixels).
+    uint64_t damage_area;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization/destruction interface.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_benchmark*
+rose_benchmark_initialize(char const* report_file_path);
+
+// Note: This function writes the report.
+void
+rose_benchmark_destroy(struct rose_benchmark* benchmark);
+
+////////////////////////////////////////////////////////////////////////////////
+// Recording interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: If the maximum number of frames has been recorded, then new frames are
+// only counted.
+void
+rose_benchmark_record_frame(
+    struct rose_benchmark* benchmark, struct rose_benchmark_frame frame);
+
+#endif // H_3B9D51E07A6C4F0E8D2B6A41C95F7E13
@@ -4,6 +4,7 @@
 // https://www.gnu.org/licenses/gpl-3.0.txt)
 //
 #include "server_context.h"
+#include "trace.h"
 
 #include <wlr/backend.h>
 #include <wlr/backend/session.h>
@@ -41,18 +42,12 @@ rose_keyboard_ipc_action_compare(void const* key, void const* action) {
 #undef action_shortcut_
 
 ////////////////////////////////////////////////////////////////////////////////
-// Event handlers.
+// Key event processing-related utility function.
 ////////////////////////////////////////////////////////////////////////////////
 
 static void
-rose_handle_event_keyboard_key(struct wl_listener* listener, void* data) {
-    // Obtain the keyboard.
-    struct rose_keyboard* keyboard =
-        wl_container_of(listener, keyboard, listener_key);
-
-    // Obtain the event.
-    struct wlr_keyboard_key_event* event = data;
-
+rose_keyboard_process_key(
+    struct rose_keyboard* keyboard, struct wlr_keyboard_key_event* event) {
     // Obtain the server context.
     struct rose_server_context* context = keyboard->parent->context;
 
@@ -295,6 +290,22 @@ rose_handle_event_keyboard_key(struct wl_listener* listener, void* data) {
         context->seat, event->time_msec, event->keycode, event->state);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Event handlers.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_handle_event_keyboard_key(struct wl_listener* listener, void* data) {
+    // Obtain the keyboard.
+    struct rose_keyboard* keyboard =
+        wl_container_of(listener, keyboard, listener_key);
+
+    // Process the event.
+    rose_trace_begin("keyboard_key");
+    rose_keyboard_process_key(keyboard, data);
+    rose_trace_end("keyboard_key");
+}
+
 static void
 rose_handle_event_keyboard_modifiers(struct wl_listener* listener, void* data) {
     // Obtain the keyboard.
@@ -309,7 +320,9 @@ rose_handle_event_keyboard_modifiers(struct wl_listener* listener, void* data) {
 
     // Notify the seat of this event, if needed.
     if(device == wlr_seat_get_keyboard(seat)) {
+        rose_trace_begin("keyboard_modifiers");
         wlr_seat_keyboard_notify_modifiers(seat, &(device->modifiers));
+        rose_trace_end("keyboard_modifiers");
     }
 }
 
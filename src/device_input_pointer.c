@@ -4,6 +4,7 @@
 // https://www.gnu.org/licenses/gpl-3.0.txt)
 //
 #include "server_context.h"
+#include "trace.h"
 
 #include <wlr/backend/libinput.h>
 #include <wlr/types/wlr_seat.h>
@@ -43,7 +44,9 @@ rose_handle_event_pointer_axis(struct wl_listener* listener, void* data) {
     struct wlr_pointer_axis_event* event = data;
 
     // Notify the workspace of this event.
+    rose_trace_begin("pointer_axis");
     rose_workspace_notify_pointer_axis(workspace, *event);
+    rose_trace_end("pointer_axis");
 }
 
 static void
@@ -60,7 +63,9 @@ rose_handle_event_pointer_button(struct wl_listener* listener, void* data) {
     struct wlr_pointer_button_event* event = data;
 
     // Notify the workspace of this event.
+    rose_trace_begin("pointer_button");
     rose_workspace_notify_pointer_button(workspace, *event);
+    rose_trace_end("pointer_button");
 }
 
 static void
@@ -77,7 +82,9 @@ rose_handle_event_pointer_motion(struct wl_listener* listener, void* data) {
     struct wlr_pointer_motion_event* event = data;
 
     // Notify the workspace of this event.
+    rose_trace_begin("pointer_motion");
     rose_workspace_notify_pointer_move(workspace, *event);
+    rose_trace_end("pointer_motion");
 }
 
 static void
@@ -95,7 +102,9 @@ rose_handle_event_pointer_motion_absolute(
     struct wlr_pointer_motion_absolute_event* event = data;
 
     // Notify the workspace of this event.
+    rose_trace_begin("pointer_motion_absolute");
     rose_workspace_notify_pointer_warp(workspace, *event);
+    rose_trace_end("pointer_motion_absolute");
 }
 
 static void
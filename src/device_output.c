@@ -3,9 +3,13 @@
 // (See accompanying file LICENSE_GPL_3_0.txt or copy at
 // https://www.gnu.org/licenses/gpl-3.0.txt)
 //
+#include "benchmark.h"
 #include "rendering.h"
+#include "rendering_glyph_atlas.h"
 #include "rendering_raster.h"
+#include "rendering_text_worker.h"
 #include "server_context.h"
+#include "trace.h"
 
 #include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_subcompositor.h>
@@ -14,6 +18,7 @@
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/render/swapchain.h>
+#include <wlr/render/wlr_renderer.h>
 
 #include <wlr/types/wlr_xdg_shell.h>
 #include <wlr/types/wlr_xcursor_manager.h>
@@ -38,6 +43,8 @@
 #define max_(a, b) ((a) > (b) ? (a) : (b))
 #define clamp_(x, a, b) max_((a), min_((x), (b)))
 
+#define array_size_(a) ((ptrdiff_t)(sizeof(a) / sizeof((a)[0])))
+
 ////////////////////////////////////////////////////////////////////////////////
 // Title string composition utility function.
 ////////////////////////////////////////////////////////////////////////////////
@@ -98,27 +105,99 @@ rose_output_workspace_compose_title_string(struct rose_workspace* workspace) {
 // Raster initialization utility function.
 ////////////////////////////////////////////////////////////////////////////////
 
+// Note: Sets the given flag if the resulting raster is not the given one (in
+// which case its contents are unspecified).
 static struct rose_raster*
 rose_output_raster_initialize(
-    struct rose_raster* raster, struct wlr_renderer* renderer, int width,
-    int height) {
+    struct rose_raster* raster, struct rose_raster_pool* pool, int width,
+    int height, bool* is_reinitialized) {
     // Clamp the dimensions.
     width = clamp_(width, 1, 32768);
     height = clamp_(height, 1, 32768);
 
     // Do nothing else if the raster is already initialized.
-    if((raster != NULL) && (raster->base.width == width) &&
-       (raster->base.height == height)) {
-        return raster;
+    if((raster != NULL) && (raster->width == width) &&
+       (raster->height == height)) {
+        return (*is_reinitialized = false), raster;
     }
 
-    // Destroy existing raster, if any.
-    if(raster != NULL) {
-        rose_raster_destroy(raster);
+    // Return existing raster, if any, to the pool.
+    rose_raster_pool_release(pool, raster);
+
+    // Obtain a raster from the pool.
+    return (*is_reinitialized = true),
+           rose_raster_pool_acquire(pool, width, height);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Title raster cache manipulation utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t
+rose_output_compute_title_hash(struct rose_utf32_string const* string) {
+    // Note: Uses FNV-1a hash function.
+    uint64_t hash = 0xCBF29CE484222325u;
+    for(size_t i = 0; i != string->size; ++i) {
+        hash = (hash ^ (uint64_t)(string->data[i])) * 0x100000001B3u;
     }
 
-    // Initialize a new raster.
-    return rose_raster_initialize(renderer, width, height);
+    return hash;
+}
+
+static bool
+rose_output_title_cache_key_equal(
+    struct rose_output_title_cache_key const* a,
+    struct rose_output_title_cache_key const* b) {
+    return (a->surface == b->surface) && (a->title_hash == b->title_hash) &&
+           (a->width == b->width) && (a->height == b->height) &&
+           (a->font_size == b->font_size) && (a->dpi == b->dpi) &&
+           (memcmp(a->color, b->color, sizeof(a->color)) == 0);
+}
+
+static struct rose_output_title_cache_entry*
+rose_output_title_cache_find(
+    struct rose_output_title_cache* cache,
+    struct rose_output_title_cache_key const* key) {
+    // Update cache's time.
+    cache->time++;
+
+    // Search the cache.
+    for(ptrdiff_t i = 0; i != rose_output_title_cache_size; ++i) {
+        struct rose_output_title_cache_entry* entry = &(cache->entries[i]);
+
+        if((entry->last_use_time != 0) &&
+           rose_output_title_cache_key_equal(&(entry->key), key)) {
+            return (entry->last_use_time = cache->time), entry;
+        }
+    }
+
+    return NULL;
+}
+
+static struct rose_output_title_cache_entry*
+rose_output_title_cache_obtain_lru_entry(
+    struct rose_output_title_cache* cache) {
+    // Note: Empty entries have zero time of the last use, so they are selected
+    // first.
+    struct rose_output_title_cache_entry* result = &(cache->entries[0]);
+
+    for(ptrdiff_t i = 0; i != rose_output_title_cache_size; ++i) {
+        if(cache->entries[i].last_use_time < result->last_use_time) {
+            result = &(cache->entries[i]);
+        }
+    }
+
+    return result;
+}
+
+static void
+rose_output_title_cache_destroy(
+    struct rose_output_title_cache* cache, struct rose_raster_pool* pool) {
+    for(ptrdiff_t i = 0; i != rose_output_title_cache_size; ++i) {
+        rose_raster_pool_release(pool, cache->entries[i].raster);
+    }
+
+    *cache = (struct rose_output_title_cache){};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -130,6 +209,100 @@ enum rose_output_rasters_update_type {
     rose_output_rasters_update_forced
 };
 
+static void
+rose_output_request_rasters_update(struct rose_output* output) {
+    // Set the flag.
+    output->is_rasters_update_requested = true;
+
+    // Schedule a frame.
+    rose_output_schedule_frame(output);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Asynchronous glyph rendering-related utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_output_handle_glyph_rendering_completion(void* data) {
+    // Obtain the output.
+    struct rose_output* output = data;
+
+    // Update output's texts using rendered glyphs.
+    output->glyph_rendering_state = rose_output_glyph_rendering_state_finished;
+    rose_output_request_rasters_update(output);
+}
+
+// Adds glyphs of the given strings which are not in the glyph cache to the
+// given set (initializes the set, if needed). Returns true if the update of
+// the strings must be postponed until their glyphs are rendered by the text
+// rendering worker.
+static bool
+rose_output_defer_glyph_rendering(
+    struct rose_output* output, struct rose_glyph_set** set,
+    struct rose_text_rendering_parameters parameters,
+    struct rose_utf32_string const* strings, size_t string_count) {
+    // Render glyphs synchronously if there is no text rendering worker, or if
+    // the worker has already rendered glyphs for this update.
+    if((output->context->text_rendering_worker == NULL) ||
+       (output->glyph_rendering_state ==
+        rose_output_glyph_rendering_state_finished)) {
+        return false;
+    }
+
+    // Postpone the update if the worker is still rendering glyphs.
+    if(output->glyph_rendering_state ==
+       rose_output_glyph_rendering_state_pending) {
+        return true;
+    }
+
+    // Initialize the set, if needed.
+    if(*set == NULL) {
+        *set = rose_glyph_set_initialize(parameters.font_size, parameters.dpi);
+        if(*set == NULL) {
+            return false;
+        }
+    }
+
+    // Add the glyphs to the set.
+    return rose_glyph_set_add_strings(
+        output->context->text_rendering_context, *set, strings, string_count);
+}
+
+static void
+rose_output_submit_glyph_rendering(
+    struct rose_output* output, struct rose_glyph_set* set) {
+    // Note: The state is reset after each update which has used glyphs
+    // rendered by the worker.
+    if(output->glyph_rendering_state ==
+       rose_output_glyph_rendering_state_finished) {
+        output->glyph_rendering_state = rose_output_glyph_rendering_state_idle;
+    }
+
+    // Do nothing else if there are no glyphs to render.
+    if((set == NULL) || rose_glyph_set_is_empty(set)) {
+        rose_glyph_set_destroy(set);
+        return;
+    }
+
+    // Submit a job to the worker. If this fails, then render the glyphs
+    // synchronously during the next update.
+    if(rose_text_rendering_worker_submit(
+           output->context->text_rendering_worker, set,
+           rose_output_handle_glyph_rendering_completion, output)) {
+        output->glyph_rendering_state =
+            rose_output_glyph_rendering_state_pending;
+    } else {
+        output->glyph_rendering_state =
+            rose_output_glyph_rendering_state_finished;
+
+        rose_output_request_rasters_update(output);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Raster update utility function.
+////////////////////////////////////////////////////////////////////////////////
+
 static void
 rose_output_update_rasters(
     struct rose_output* output,
@@ -157,6 +330,30 @@ rose_output_update_rasters(
     struct rose_color_scheme const* color_scheme =
         &(output->context->config.theme.color_scheme);
 
+    // Obtain output's glyph atlas.
+    // Note: The atlas is used only if glyph storage for all texts is available.
+    struct rose_glyph_atlas* atlas =
+        (((output->glyphs.title != NULL) && (output->glyphs.menu != NULL))
+             ? output->glyphs.atlas
+             : NULL);
+
+    // If the atlas has run out of space, then reset it, and force the update
+    // of all texts.
+    if((atlas != NULL) && rose_glyph_atlas_is_full(atlas)) {
+        rose_glyph_atlas_reset(atlas);
+
+        output->glyphs.title->is_valid = false;
+        output->glyphs.menu->is_valid = false;
+
+        update_type = rose_output_rasters_update_forced;
+    }
+
+    // Initialize storage for glyph placements.
+    struct rose_glyph_placement_list placements;
+
+    // Initialize an empty set of glyphs which must be rendered asynchronously.
+    struct rose_glyph_set* glyph_set = NULL;
+
     // Obtain panel's data.
     struct rose_ui_panel panel = workspace->panel;
     if(panel.is_visible) {
@@ -171,13 +368,26 @@ rose_output_update_rasters(
     // Update title's raster, if needed.
     while(panel.is_visible) {
         // Stop the update, if needed.
+        // Note: If title's glyphs have been invalidated, then the title must be
+        // updated, since title's raster might be outdated.
         if((update_type == rose_output_rasters_update_normal) &&
+           ((atlas == NULL) || (output->glyphs.title->is_valid)) &&
            (output->focused_surface == workspace->focused_surface) &&
            ((output->focused_surface == NULL) ||
             !(output->focused_surface->is_name_updated))) {
             break;
         }
 
+        // Compose the title.
+        struct rose_utf32_string title =
+            rose_output_workspace_compose_title_string(workspace);
+
+        // Postpone the update if title's glyphs must be rendered first.
+        if(rose_output_defer_glyph_rendering(
+               output, &glyph_set, text_rendering_parameters, &title, 1)) {
+            break;
+        }
+
         // Update the focused surface.
         output->focused_surface = workspace->focused_surface;
         if(output->focused_surface != NULL) {
@@ -193,11 +403,66 @@ rose_output_update_rasters(
                  2),
             height = (int)(panel.size * output_state.scale + 0.5);
 
+        // Set text's color.
+        text_rendering_parameters.color = color_scheme->panel_foreground;
+
+        // Add title's glyphs to the atlas, if possible. If this succeeds, then
+        // title's raster is not needed.
+        if(atlas != NULL) {
+            struct rose_glyph_atlas_text* glyphs = output->glyphs.title;
+
+            rose_place_string(
+                text_rendering_context, text_rendering_parameters, title,
+                width, height, &placements);
+
+            glyphs->width = width;
+            glyphs->height = height;
+            glyphs->is_valid = rose_glyph_atlas_add_glyphs(
+                atlas, &placements, text_rendering_parameters.color, 0,
+                &(glyphs->lines[0]));
+
+            if(glyphs->is_valid) {
+                break;
+            }
+        }
+
+        // Initialize title cache's key.
+        struct rose_output_title_cache_key key = {
+            .surface = output->focused_surface,
+            .title_hash = rose_output_compute_title_hash(&title),
+            .width = width,
+            .height = height,
+            .font_size = text_rendering_parameters.font_size,
+            .dpi = text_rendering_parameters.dpi};
+
+        memcpy(
+            key.color, text_rendering_parameters.color.rgba8,
+            sizeof(key.color));
+
+        // Search the cache. If the title has been rendered recently, then use
+        // its raster.
+        struct rose_output_title_cache* cache =
+            &(output->rasters.title_cache);
+
+        struct rose_output_title_cache_entry* entry =
+            rose_output_title_cache_find(cache, &key);
+
+        if(entry != NULL) {
+            output->rasters.title = entry->raster;
+            break;
+        }
+
+        // Otherwise, reuse the least recently used entry. Invalidate it until
+        // its raster is updated.
+        entry = rose_output_title_cache_obtain_lru_entry(cache);
+        entry->last_use_time = 0;
+
         // Initialize the raster.
-        struct rose_raster* raster = output->rasters.title =
+        bool is_reinitialized = false;
+        struct rose_raster* raster = output->rasters.title = entry->raster =
             rose_output_raster_initialize(
-                output->rasters.title, output->context->renderer, width,
-                height);
+                entry->raster, output->context->raster_pool, width, height,
+                &is_reinitialized);
 
         // Stop the update if the raster is not initialized.
         if(raster == NULL) {
@@ -207,19 +472,16 @@ rose_output_update_rasters(
         // Clear the raster.
         rose_raster_clear(raster);
 
-        // Set text's color.
-        text_rendering_parameters.color = color_scheme->panel_foreground;
-
         // Initialize a pixel buffer for text rendering.
         struct rose_pixel_buffer pixels = {
             .data = raster->pixels,
-            .width = raster->base.width,
-            .height = raster->base.height};
+            .width = raster->width,
+            .height = raster->height,
+            .pitch = 4 * raster->base.width};
 
-        // Compose and render the title.
+        // Render the title.
         rose_render_string(
-            text_rendering_context, text_rendering_parameters,
-            rose_output_workspace_compose_title_string(workspace), pixels);
+            text_rendering_context, text_rendering_parameters, title, pixels);
 
         // Update raster's texture.
         pixman_region32_t region = {
@@ -228,6 +490,10 @@ rose_output_update_rasters(
 
         rose_raster_texture_update(raster, &region);
 
+        // Add the title to the cache.
+        entry->key = key;
+        entry->last_use_time = cache->time;
+
         // Note: Update succeeded.
         break;
     }
@@ -241,42 +507,125 @@ rose_output_update_rasters(
         int width = (int)(menu->area.width * output_state.scale + 0.5),
             height = (int)(menu->area.height * output_state.scale + 0.5);
 
-        // Initialize the raster.
-        struct rose_raster* raster = output->rasters.menu =
-            rose_output_raster_initialize(
-                output->rasters.menu, output->context->renderer, width, height);
-
-        // Stop the update if the raster is not initialized.
-        if(raster == NULL) {
-            break;
-        }
+        // Compute menu line's height in raster's space.
+        int line_height =
+            (int)(menu->layout.line_height * output_state.scale + 0.5);
 
         // Obtain menu's previous and current texts.
         struct rose_ui_menu_text text_prev = output->ui_menu_text;
         struct rose_ui_menu_text text = rose_ui_menu_text_obtain(menu);
 
+        // Postpone the update if glyphs of menu's text must be rendered first.
+        if(rose_output_defer_glyph_rendering(
+               output, &glyph_set, text_rendering_parameters, text.lines,
+               (size_t)(text.line_count))) {
+            break;
+        }
+
         // Save menu's current text.
         output->ui_menu_text = text;
 
         // Set text's color.
         text_rendering_parameters.color = color_scheme->menu_foreground;
 
+#define line_diff_(a, b)   \
+    ((a.size != b.size) || \
+     (memcmp(a.data, b.data, a.size * sizeof(a.data[0])) != 0))
+
+        // Add glyphs of the lines to the atlas, if possible. If this succeeds,
+        // then menu's raster is not needed.
+        if(atlas != NULL) {
+            struct rose_glyph_atlas_text* glyphs = output->glyphs.menu;
+
+            // Note: All lines must be updated if menu's layout has changed, or
+            // if the glyphs are not valid.
+            bool must_update_all_lines =
+                (menu->is_layout_updated) || !(glyphs->is_valid) ||
+                (glyphs->width != width) || (glyphs->height != height);
+
+            glyphs->width = width;
+            glyphs->height = height;
+            glyphs->is_valid = true;
+
+            // Update the lines.
+            int space_left = height;
+            for(ptrdiff_t i = 0; i < glyphs->line_count; ++i) {
+                struct rose_glyph_atlas_text_line* line = &(glyphs->lines[i]);
+
+                // Remove lines which are not visible.
+                if((i >= text.line_count) || (space_left <= 0)) {
+                    line->size = 0;
+                    continue;
+                }
+
+                // Compute current line's height.
+                int line_pixels_height = min_(line_height, space_left);
+
+                // Update available space.
+                space_left -= line_height;
+
+                // Skip the line if it has not changed.
+                if(!must_update_all_lines && (i < text_prev.line_count) &&
+                   !line_diff_(text.lines[i], text_prev.lines[i])) {
+                    continue;
+                }
+
+                // Add line's glyphs to the atlas.
+                rose_place_string(
+                    text_rendering_context, text_rendering_parameters,
+                    text.lines[i], width, line_pixels_height, &placements);
+
+                if(!rose_glyph_atlas_add_glyphs(
+                       atlas, &placements, text_rendering_parameters.color,
+                       (int)(i * line_height), line)) {
+                    glyphs->is_valid = false;
+                    break;
+                }
+            }
+
+            // Finish the update if the glyphs are valid.
+            if(glyphs->is_valid) {
+                menu->is_updated = menu->is_layout_updated = false;
+                break;
+            }
+        }
+
+        // Initialize the raster.
+        bool is_reinitialized = false;
+        struct rose_raster* raster = output->rasters.menu =
+            rose_output_raster_initialize(
+                output->rasters.menu, output->context->raster_pool, width,
+                height, &is_reinitialized);
+
+        // Stop the update if the raster is not initialized. Restore menu's
+        // previous text, so that the next update renders all changed lines.
+        if(raster == NULL) {
+            output->ui_menu_text = text_prev;
+            break;
+        }
+
         // Render the text line-by-line, compute raster's updated area.
         int updated_area[2] = {-1, 0};
         if(true) {
-            // Compute menu line's height in raster's space.
-            int line_height =
-                (int)(menu->layout.line_height * output_state.scale + 0.5);
-
             // Initialize a pixel buffer for a text line.
             struct rose_pixel_buffer line_pixels = {
-                .width = raster->base.width, .height = line_height};
+                .width = raster->width,
+                .height = line_height,
+                .pitch = 4 * raster->base.width};
 
             // Compute text line's stride.
-            ptrdiff_t line_stride = 4 * line_pixels.width * line_pixels.height;
+            ptrdiff_t line_stride = line_pixels.pitch * line_pixels.height;
+
+            // If the raster has been obtained from the pool, then clear it, and
+            // update its whole texture.
+            if(is_reinitialized) {
+                rose_raster_clear(raster);
+                updated_area[0] = 0;
+                updated_area[1] = raster->height;
+            }
 
             // Render the lines.
-            int space_left = raster->base.height;
+            int space_left = raster->height;
             for(ptrdiff_t i = 0; i < text.line_count; ++i) {
                 // Stop rendering if there is no space left in the raster.
                 if(space_left <= 0) {
@@ -290,17 +639,15 @@ rose_output_update_rasters(
                 // Update raster's available space.
                 space_left -= line_height;
 
-#define line_diff_(a, b)   \
-    ((a.size != b.size) || \
-     (memcmp(a.data, b.data, a.size * sizeof(a.data[0])) != 0))
-
                 // A flag which shows that current line must be rendered.
+                // Note: If the atlas is available, then raster's contents are
+                // outdated, since the menu has been rendered from the atlas.
                 bool must_render_line =
-                    (menu->is_layout_updated) || (i >= text_prev.line_count) ||
+                    (menu->is_layout_updated) || (atlas != NULL) ||
+                    (is_reinitialized) ||
+                    (i >= text_prev.line_count) ||
                     (line_diff_(text.lines[i], text_prev.lines[i]));
 
-#undef line_diff_
-
                 // Render the line, if needed.
                 if(must_render_line) {
                     // Compute line's offset.
@@ -309,12 +656,13 @@ rose_output_update_rasters(
                     // Compute updated area.
                     updated_area[0] =
                         ((updated_area[0] < 0) ? dy : updated_area[0]);
-                    updated_area[1] = dy + line_pixels.height;
+                    updated_area[1] =
+                        max_(updated_area[1], dy + line_pixels.height);
 
                     // Clear line's pixel buffer.
                     memset(
                         line_pixels.data, 0,
-                        4 * line_pixels.width * line_pixels.height);
+                        line_pixels.pitch * line_pixels.height);
 
                     // Render the current line.
                     rose_render_string(
@@ -330,7 +678,7 @@ rose_output_update_rasters(
                 .extents = {
                     .x1 = 0,
                     .y1 = updated_area[0],
-                    .x2 = raster->base.width,
+                    .x2 = raster->width,
                     .y2 = updated_area[1]}};
 
             rose_raster_texture_update(raster, &region);
@@ -342,15 +690,18 @@ rose_output_update_rasters(
         // Note: Update succeeded.
         break;
     }
-}
 
-static void
-rose_output_request_rasters_update(struct rose_output* output) {
-    // Set the flag.
-    output->is_rasters_update_requested = true;
+#undef line_diff_
 
-    // Schedule a frame.
-    rose_output_schedule_frame(output);
+    // Upload newly added glyphs to atlas' texture.
+    if(atlas != NULL) {
+        rose_glyph_atlas_flush(atlas);
+    }
+
+    // Render missing glyphs asynchronously, if needed.
+    if(output->context->text_rendering_worker != NULL) {
+        rose_output_submit_glyph_rendering(output, glyph_set);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -461,42 +812,6 @@ rose_output_add_workspaces(struct rose_output* output) {
 // Damage handling utility functions.
 ////////////////////////////////////////////////////////////////////////////////
 
-static struct rose_output_damage
-rose_output_damage_construct(pixman_region32_t const* region) {
-    return (struct rose_output_damage){
-        .x = region->extents.x1,
-        .y = region->extents.y1,
-        .width = (region->extents.x2 - region->extents.x1),
-        .height = (region->extents.y2 - region->extents.y1)};
-}
-
-static struct rose_output_damage
-rose_output_damage_compute_union(
-    struct rose_output_damage a, struct rose_output_damage b) {
-    if((a.width == 0) || (a.height == 0)) {
-        return b;
-    } else if((b.width == 0) || (b.height == 0)) {
-        return a;
-    }
-
-#define shift_(damage)            \
-    (damage).width += (damage).x; \
-    (damage).height += (damage).y;
-
-    shift_(a);
-    shift_(b);
-
-#undef shift_
-
-    a.x = min_(a.x, b.x);
-    a.y = min_(a.y, b.y);
-
-    a.width = max_(a.width, b.width) - a.x;
-    a.height = max_(a.height, b.height) - a.y;
-
-    return a;
-}
-
 static struct rose_output_damage
 rose_output_damage_transform(
     struct rose_output_damage source, struct rose_output_state state) {
@@ -569,22 +884,283 @@ rose_output_damage_transform(
     return result;
 }
 
-static struct rose_output_damage
-rose_output_damage_obtain(struct wlr_surface* surface) {
-    // Initialize an empty region.
-    pixman_region32_t region;
-    pixman_region32_init(&region);
+static void
+rose_output_damage_region_transform(
+    pixman_region32_t* result, pixman_region32_t const* source,
+    struct rose_output_state state) {
+    // Clear the resulting region.
+    pixman_region32_clear(result);
+
+    // Obtain source region's rectangles.
+    int rectangle_count = 0;
+    pixman_box32_t const* rectangles =
+        pixman_region32_rectangles(source, &rectangle_count);
+
+    // Transform each rectangle and add it to the resulting region.
+    for(int i = 0; i != rectangle_count; ++i) {
+        struct rose_output_damage damage = rose_output_damage_transform(
+            (struct rose_output_damage){
+                .x = rectangles[i].x1,
+                .y = rectangles[i].y1,
+                .width = (rectangles[i].x2 - rectangles[i].x1),
+                .height = (rectangles[i].y2 - rectangles[i].y1)},
+            state);
+
+        pixman_region32_union_rect(
+            result, result, damage.x, damage.y, damage.width, damage.height);
+    }
+}
+
+static void
+rose_output_damage_region_limit(pixman_region32_t* region, int limit) {
+    // If the region consists of too many rectangles, then replace it with its
+    // bounding box.
+    if(pixman_region32_n_rects(region) > limit) {
+        pixman_box32_t extents = *pixman_region32_extents(region);
+        pixman_region32_reset(region, &extents);
+    }
+}
+
+static void
+rose_output_damage_region_obtain(
+    struct rose_output* output, ptrdiff_t i, pixman_region32_t* result) {
+    // Obtain and transform damage with the given index.
+    rose_output_damage_region_transform(
+        result, &(output->damage_tracker.regions[i]),
+        rose_output_state_obtain(output));
+
+    // Clip the resulting region to output's area, and limit the number of its
+    // rectangles.
+    pixman_region32_intersect_rect(
+        result, result, 0, 0, output->device->width, output->device->height);
+
+    rose_output_damage_region_limit(
+        result, output->damage_tracker.rectangle_count_max);
+}
+
+struct rose_output_surface_extent_context {
+    // Surface's offset.
+    int dx, dy;
+
+    // Region which is occupied by the surfaces.
+    pixman_region32_t* region;
+};
+
+static void
+rose_output_surface_extent_add(
+    struct wlr_surface* surface, int x, int y, void* data) {
+    // Obtain the context.
+    struct rose_output_surface_extent_context* context = data;
+
+    // Surfaces without buffers do not occupy anything.
+    if(!wlr_surface_has_buffer(surface)) {
+        return;
+    }
 
-    // Construct resulting damage.
-    struct rose_output_damage result = rose_output_damage_construct(
-        (wlr_surface_get_effective_damage(surface, &region), &region));
+    // Add surface's area to the region.
+    pixman_region32_union_rect(
+        context->region, context->region, x + context->dx, y + context->dy,
+        surface->current.width, surface->current.height);
+}
 
-    // Return resulting damage.
-    return pixman_region32_fini(&region), result;
+static void
+rose_output_damage_region_add_surface_tree(
+    pixman_region32_t* region, struct wlr_xdg_surface* xdg_surface, int x,
+    int y) {
+    // Add areas of the surface and its child entities (subsurfaces and popups)
+    // to the region.
+    struct rose_output_surface_extent_context context = {
+        .dx = x, .dy = y, .region = region};
+
+    wlr_xdg_surface_for_each_surface(
+        xdg_surface, rose_output_surface_extent_add, &context);
+}
+
+static void
+rose_output_add_damage_region(
+    struct rose_output* output, pixman_region32_t const* region) {
+    // Mark the output as damaged.
+    output->damage_tracker.frame_without_damage_count = 0;
+
+    // Add the damage.
+    for(ptrdiff_t i = 0; i != array_size_(output->damage_tracker.regions);
+        ++i) {
+        pixman_region32_t* x = &(output->damage_tracker.regions[i]);
+
+        pixman_region32_union(x, x, region);
+        rose_output_damage_region_limit(
+            x, output->damage_tracker.rectangle_count_max);
+    }
+
+    // Schedule a frame.
+    rose_output_schedule_frame(output);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Surface notification-related utility function.
+// Frame rendering-related utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t
+rose_output_convert_time(struct timespec const* timestamp) {
+    return (uint64_t)(timestamp->tv_sec) * 1000000000 +
+           (uint64_t)(timestamp->tv_nsec);
+}
+
+static uint64_t
+rose_output_obtain_time(clockid_t clock_id) {
+    struct timespec timestamp = {};
+    clock_gettime(clock_id, &timestamp);
+
+    return rose_output_convert_time(&timestamp);
+}
+
+static uint64_t
+rose_output_obtain_refresh_period(struct rose_output* output) {
+    // Note: With adaptive sync the next vertical blank can not be predicted,
+    // hence the period is considered unknown.
+    if((output->device->refresh <= 0) ||
+       (output->device->adaptive_sync_status ==
+        WLR_OUTPUT_ADAPTIVE_SYNC_ENABLED)) {
+        return 0;
+    }
+
+    // Compute the period (in nanoseconds).
+    return UINT64_C(1000000000000) / (uint64_t)(output->device->refresh);
+}
+
+static void
+rose_output_record_frame(
+    struct rose_output* output, struct rose_rendering_result result,
+    uint64_t time, uint64_t cpu_time) {
+    static enum rose_metrics_counter_type const counter_types[] = {
+        [rose_metrics_frame_type_rendered] =
+            rose_metrics_counter_type_frames_rendered,
+        [rose_metrics_frame_type_scanned_out] =
+            rose_metrics_counter_type_frames_scanned_out,
+        [rose_metrics_frame_type_skipped] =
+            rose_metrics_counter_type_frames_skipped};
+
+    // Obtain the metrics.
+    struct rose_metrics* metrics = &(output->context->metrics);
+
+    // Determine frame's type.
+    enum rose_metrics_frame_type type = rose_metrics_frame_type_skipped;
+    switch(result.type) {
+        case rose_rendering_result_type_rendered:
+            type = rose_metrics_frame_type_rendered;
+            break;
+
+        case rose_rendering_result_type_scanned_out:
+            type = rose_metrics_frame_type_scanned_out;
+            break;
+
+        default:
+            break;
+    }
+
+    // Update the metrics.
+    output->frame_counts[type]++;
+    rose_metrics_counter_add(metrics, counter_types[type], 1);
+
+    if(type != rose_metrics_frame_type_skipped) {
+        rose_metrics_histogram_observe(
+            metrics, rose_metrics_histogram_type_frame_rendering_time, time);
+    }
+
+    if(type == rose_metrics_frame_type_rendered) {
+        rose_metrics_histogram_observe(
+            metrics, rose_metrics_histogram_type_frame_damage_area,
+            result.damage_area);
+    }
+
+    // Record the frame, if there is a running benchmark.
+    if(output->context->benchmark != NULL) {
+        static enum rose_benchmark_frame_type const frame_types[] = {
+            [rose_metrics_frame_type_rendered] =
+                rose_benchmark_frame_type_rendered,
+            [rose_metrics_frame_type_scanned_out] =
+                rose_benchmark_frame_type_scanned_out,
+            [rose_metrics_frame_type_skipped] =
+                rose_benchmark_frame_type_skipped};
+
+        rose_benchmark_record_frame(
+            output->context->benchmark,
+            (struct rose_benchmark_frame){
+                .output_id = output->id,
+                .type = frame_types[type],
+                .time = rose_output_obtain_time(CLOCK_MONOTONIC),
+                .cpu_time = cpu_time,
+                .damage_area = result.damage_area});
+    }
+}
+
+static void
+rose_output_record_pending_rendering_time(struct rose_output* output) {
+    // Obtain output's frame scheduler.
+    struct rose_output_frame_scheduler* scheduler = &(output->frame_scheduler);
+
+    // Do nothing if there is no pending measurement.
+    if(!(scheduler->is_render_timer_pending)) {
+        return;
+    }
+
+    // Obtain timer's measurement.
+    // Note: The measurement is obtained before rendering the next frame, at
+    // which point the GPU has already finished rendering the previous one, so
+    // this operation does not stall.
+    int timer_time = wlr_render_timer_get_duration_ns(scheduler->render_timer);
+
+    // Record the maximum of the measured times. If timer's measurement could
+    // not be obtained, then only CPU time is used.
+    uint64_t time = scheduler->pending_rendering_time;
+    if((timer_time > 0) && ((uint64_t)(timer_time) > time)) {
+        time = (uint64_t)(timer_time);
+    }
+
+    rose_output_frame_scheduler_record_rendering_time(scheduler, time);
+    scheduler->is_render_timer_pending = false;
+}
+
+static void
+rose_output_render_content(struct rose_output* output) {
+    // Record rendering time of the previous frame, if it is pending.
+    rose_output_record_pending_rendering_time(output);
+
+    // Determine the clock which measures CPU time.
+    // Note: CPU time is only measured if there is a running benchmark.
+    bool is_cpu_time_measured = (output->context->benchmark != NULL);
+    clockid_t cpu_clock_id = CLOCK_THREAD_CPUTIME_ID;
+
+    // Render output's content, and measure the time spent doing so.
+    uint64_t c0 =
+        (is_cpu_time_measured ? rose_output_obtain_time(cpu_clock_id) : 0);
+    uint64_t t0 = rose_output_obtain_time(CLOCK_MONOTONIC);
+
+    rose_trace_begin("render_content");
+    struct rose_rendering_result result = rose_render_content(output);
+    rose_trace_end("render_content");
+
+    uint64_t t1 = rose_output_obtain_time(CLOCK_MONOTONIC);
+    uint64_t c1 =
+        (is_cpu_time_measured ? rose_output_obtain_time(cpu_clock_id) : 0);
+
+    // Record the frame.
+    rose_output_record_frame(output, result, t1 - t0, c1 - c0);
+
+    // Update frame scheduler's measurements. If rendering has been measured
+    // by the timer, then the time is recorded after timer's measurement is
+    // obtained.
+    if(result.is_timed) {
+        output->frame_scheduler.pending_rendering_time = t1 - t0;
+        output->frame_scheduler.is_render_timer_pending = true;
+    } else {
+        rose_output_frame_scheduler_record_rendering_time(
+            &(output->frame_scheduler), t1 - t0);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Surface notification-related utility functions.
 ////////////////////////////////////////////////////////////////////////////////
 
 static void
@@ -596,18 +1172,186 @@ rose_output_surface_send_frame_done(
     wlr_surface_send_frame_done(surface, data);
 }
 
-////////////////////////////////////////////////////////////////////////////////
-// Event handlers.
-////////////////////////////////////////////////////////////////////////////////
+static void
+rose_output_frame_done_timer_arm(
+    struct rose_output* output, uint64_t deadline, uint64_t time) {
+    // Obtain output's frame scheduler.
+    struct rose_output_frame_scheduler* scheduler = &(output->frame_scheduler);
+
+    // Do nothing if the timer already fires earlier.
+    if((scheduler->frame_done_deadline != 0) &&
+       (scheduler->frame_done_deadline <= deadline)) {
+        return;
+    }
+
+    // Arm the timer.
+    // Note: The delay is rounded up, so that the timer never fires too early.
+    scheduler->frame_done_deadline = deadline;
+    wl_event_source_timer_update(
+        scheduler->frame_done_timer,
+        (int)((deadline - time + 999999) / 1000000));
+}
 
 static void
-rose_handle_event_output_frame(struct wl_listener* listener, void* data) {
-    unused_(data);
+rose_output_surface_frame_done_send(
+    struct rose_output* output, struct rose_surface* surface,
+    struct timespec const* timestamp) {
+    // Only measure the lead time if the client is waiting for the event, and
+    // output's refresh period is known.
+    // Note: Idle clients have no pending frame callbacks, and their next commit
+    // is not a response to this event. The list must be checked before sending
+    // the event, since sending empties it.
+    uint64_t refresh_period = rose_output_obtain_refresh_period(output);
+    bool is_measured =
+        (refresh_period != 0) &&
+        !wl_list_empty(
+            &(surface->xdg_surface->surface->current.frame_callback_list));
+
+    // Send frame done events to the surface and its child entities.
+    wlr_xdg_surface_for_each_surface(
+        surface->xdg_surface, rose_output_surface_send_frame_done,
+        (void*)(timestamp));
+
+    // Update surface's frame pacing data.
+    surface->frame_pacing.frame_done_time =
+        (is_measured ? rose_output_convert_time(timestamp) : 0);
+    surface->frame_pacing.frame_done_deadline = 0;
+    surface->frame_pacing.refresh_period = refresh_period;
+}
 
-    // Obtain the output.
-    struct rose_output* output =
-        wl_container_of(listener, output, listener_frame);
+static void
+rose_output_surface_frame_done_schedule(
+    struct rose_output* output, struct rose_surface* surface,
+    struct timespec const* timestamp) {
+    // Occluded surfaces receive throttled frame done events.
+    if(surface->is_occluded) {
+        return;
+    }
+
+    // Compute the time when frame done event must be sent.
+    uint64_t deadline = rose_output_frame_scheduler_compute_frame_done_time(
+        &(output->frame_scheduler), rose_output_obtain_refresh_period(output),
+        rose_output_frame_time_history_predict(
+            &(surface->frame_pacing.commit_times)));
+
+    // Send the event immediately, if needed.
+    // Note: Delays shorter than a millisecond are not worth a timer.
+    uint64_t time = rose_output_convert_time(timestamp);
+    if((output->frame_scheduler.frame_done_timer == NULL) ||
+       (deadline <= (time + 1000000))) {
+        return rose_output_surface_frame_done_send(output, surface, timestamp);
+    }
+
+    // Otherwise, delay it.
+    surface->frame_pacing.frame_done_deadline = deadline;
+    rose_output_frame_done_timer_arm(output, deadline, time);
+}
+
+static void
+rose_output_surface_frame_done_flush(
+    struct rose_output* output, struct rose_surface* surface,
+    struct timespec const* timestamp) {
+    // Do nothing if there is no delayed frame done event.
+    uint64_t deadline = surface->frame_pacing.frame_done_deadline;
+    if(deadline == 0) {
+        return;
+    }
+
+    // Send the event if its time has come, or re-arm the timer otherwise.
+    uint64_t time = rose_output_convert_time(timestamp);
+    if(deadline <= (time + 1000000)) {
+        rose_output_surface_frame_done_send(output, surface, timestamp);
+    } else {
+        rose_output_frame_done_timer_arm(output, deadline, time);
+    }
+}
+
+static void
+rose_output_frame_done_throttling_timer_arm(struct rose_output* output) {
+    // Do nothing if there is no timer, or if it is already armed.
+    if((output->frame_done_throttling.timer == NULL) ||
+       output->frame_done_throttling.is_timer_armed) {
+        return;
+    }
+
+    // Arm the timer.
+    output->frame_done_throttling.is_timer_armed = true;
+    wl_event_source_timer_update(
+        output->frame_done_throttling.timer,
+        (int)(output->frame_done_throttling.interval));
+}
+
+static bool
+rose_output_send_throttled_frame_done(
+    struct rose_output* output, struct timespec const* timestamp) {
+    // Send frame done events to the surfaces which can not be seen.
+    bool has_hidden_surfaces = false;
+
+    struct rose_workspace* workspace = NULL;
+    wl_list_for_each(workspace, &(output->workspaces), link_output) {
+        // Determine if the workspace can be seen.
+        bool is_workspace_visible =
+            (workspace == output->focused_workspace) &&
+            !(output->context->is_screen_locked);
+
+        struct rose_surface* surface = NULL;
+        wl_list_for_each(surface, &(workspace->surfaces_mapped), link_mapped) {
+            // Skip the surfaces which receive frame done events on each frame.
+            if(is_workspace_visible &&
+               ((surface->is_visible && !(surface->is_occluded)) ||
+                surface->is_transaction_running)) {
+                continue;
+            }
+
+            // Send the event.
+            rose_output_surface_frame_done_send(output, surface, timestamp);
+            has_hidden_surfaces = true;
+        }
+    }
+
+    return has_hidden_surfaces;
+}
+
+static void
+rose_output_for_each_visible_surface(
+    struct rose_output* output,
+    void (*f)(struct rose_output*, struct rose_surface*,
+              struct timespec const*),
+    struct timespec const* timestamp) {
+    // Obtain output's focused workspace.
+    struct rose_workspace* workspace = output->focused_workspace;
+
+    // Process visible surfaces of the focused workspace, unless the screen is
+    // locked, or there is a running workspace transaction.
+    if(!(output->context->is_screen_locked) && (workspace != NULL) &&
+       (workspace->transaction.sentinel == 0)) {
+        struct rose_surface* surface = NULL;
+        wl_list_for_each(
+            surface, &(workspace->surfaces_visible), link_visible) {
+            f(output, surface, timestamp);
+        }
+    }
 
+    // Process visible widgets.
+    if(true) {
+        struct rose_surface* surface = NULL;
+        for(ptrdiff_t i = 0; i != rose_surface_widget_type_count_; ++i) {
+            wl_list_for_each(
+                surface, &(output->ui.surfaces_mapped[i]), link_mapped) {
+                if(rose_output_ui_is_surface_visible(&(output->ui), surface)) {
+                    f(output, surface, timestamp);
+                }
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame processing-related utility function.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_output_process_frame(struct rose_output* output) {
     // Reset this flag, since at this point no frame is scheduled.
     output->is_frame_scheduled = false;
 
@@ -670,7 +1414,7 @@ rose_handle_event_output_frame(struct wl_listener* listener, void* data) {
             if(output->is_scanned_out) {
                 // If the output was in direct scan-out mode, then try using
                 // this mode again by rendering output's content.
-                rose_render_content(output);
+                rose_output_render_content(output);
             } else {
                 // Otherwise, swap buffers.
                 if(output->device->swapchain != NULL) {
@@ -686,11 +1430,21 @@ rose_handle_event_output_frame(struct wl_listener* listener, void* data) {
                         output->device->swapchain, &buffer_age);
 
                     // Consume damage.
-                    rose_output_consume_damage(output, buffer_age);
+                    // Note: The acquired buffer contains a frame which has
+                    // been rendered earlier, hence it can differ from current
+                    // frame in the area which has been damaged since then.
+                    pixman_region32_t damage;
+                    pixman_region32_init(&damage);
 
-                    // Set acquired buffer as current.
+                    rose_output_consume_damage(
+                        output, buffer_age, &damage, NULL);
+
+                    // Set acquired buffer as current, along with its damage.
                     wlr_output_state_set_buffer(&state, buffer);
+                    wlr_output_state_set_damage(&state, &damage);
+
                     wlr_buffer_unlock(buffer);
+                    pixman_region32_fini(&damage);
 
                     // Commit the state.
                     wlr_output_commit_state(output->device, &state);
@@ -700,6 +1454,10 @@ rose_handle_event_output_frame(struct wl_listener* listener, void* data) {
                 } else {
                     wlr_output_schedule_frame(output->device);
                 }
+
+                // Note: Output's content has not been rendered.
+                rose_output_record_frame(
+                    output, (struct rose_rendering_result){}, 0, 0);
             }
 
             // Go to the end of the routine to update the flags.
@@ -710,62 +1468,43 @@ rose_handle_event_output_frame(struct wl_listener* listener, void* data) {
             // Proceed with rendering.
         } else {
             // Do nothing else.
-            return;
+            return rose_output_record_frame(
+                output, (struct rose_rendering_result){}, 0, 0);
         }
     }
 
     // Render output's content.
-    rose_render_content(output);
+    rose_output_render_content(output);
 
     // Update the timestamp.
     // Note: Because rendering operation takes some time, the previous timestamp
     // might have become outdated at this point.
     clock_gettime(CLOCK_MONOTONIC, &timestamp);
 
-    // Send frame done events to all relevant surfaces.
-    if(!(output->context->is_screen_locked)) {
-        // If there is a focused workspace, then send required frame done events
-        // to its surfaces.
-        if(workspace != NULL) {
-            struct rose_surface* surface = NULL;
-            if(workspace->transaction.sentinel > 0) {
-                // If there is a running workspace transaction, then send frame
-                // done events to all mapped surfaces which are part of this
-                // transaction.
-                wl_list_for_each(
-                    surface, &(workspace->surfaces_mapped), link_mapped) {
-                    if(surface->is_transaction_running) {
-                        wlr_surface_send_frame_done(
-                            surface->xdg_surface->surface, &timestamp);
-                    }
-                }
-            } else {
-                // Otherwise, send frame done events to all visible surfaces.
-                wl_list_for_each(
-                    surface, &(workspace->surfaces_visible), link_visible) {
-                    wlr_xdg_surface_for_each_surface(
-                        surface->xdg_surface,
-                        rose_output_surface_send_frame_done, &timestamp);
-                }
-            }
-        }
-    }
-
-    // Send frame done events to all visible widgets.
-    if(true) {
+    // If there is a running workspace transaction, then send frame done events
+    // to all mapped surfaces which are part of this transaction.
+    if(!(output->context->is_screen_locked) && (workspace != NULL) &&
+       (workspace->transaction.sentinel > 0)) {
         struct rose_surface* surface = NULL;
-        for(ptrdiff_t i = 0; i != rose_surface_widget_type_count_; ++i) {
-            wl_list_for_each(
-                surface, &(output->ui.surfaces_mapped[i]), link_mapped) {
-                if(rose_output_ui_is_surface_visible(&(output->ui), surface)) {
-                    wlr_xdg_surface_for_each_surface(
-                        surface->xdg_surface,
-                        rose_output_surface_send_frame_done, &timestamp);
-                }
+        wl_list_for_each(surface, &(workspace->surfaces_mapped), link_mapped) {
+            if(surface->is_transaction_running) {
+                wlr_surface_send_frame_done(
+                    surface->xdg_surface->surface, &timestamp);
             }
         }
     }
 
+    // Send frame done events to all visible surfaces and widgets.
+    // Note: Events are delayed for the surfaces which commit new frames fast
+    // enough, so that they render with fresh input, and still make the
+    // deadline of the next frame.
+    rose_output_for_each_visible_surface(
+        output, rose_output_surface_frame_done_schedule, &timestamp);
+
+    // Make sure that the surfaces which can not be seen receive throttled
+    // frame done events.
+    rose_output_frame_done_throttling_timer_arm(output);
+
 end:
 
     // Update output's flags.
@@ -773,6 +1512,104 @@ end:
     output->cursor.has_moved = false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Event handlers.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_handle_event_output_frame(struct wl_listener* listener, void* data) {
+    unused_(data);
+
+    // Obtain the output.
+    struct rose_output* output =
+        wl_container_of(listener, output, listener_frame);
+
+    // Do nothing if a delayed frame is pending.
+    if(output->frame_scheduler.is_frame_pending) {
+        return;
+    }
+
+    // Delay the frame, if needed.
+    // Note: The delay is anchored at the last vertical blank. Frames which do
+    // not follow a vertical blank are not delayed.
+    if(output->frame_scheduler.timer != NULL) {
+        unsigned delay = rose_output_frame_scheduler_compute_delay(
+            &(output->frame_scheduler),
+            rose_output_obtain_refresh_period(output),
+            rose_output_obtain_time(CLOCK_MONOTONIC));
+
+        if(delay != 0) {
+            output->frame_scheduler.is_frame_pending = true;
+            wl_event_source_timer_update(output->frame_scheduler.timer, delay);
+
+            return;
+        }
+    }
+
+    // Process the frame.
+    rose_trace_begin("output_frame");
+    rose_output_process_frame(output);
+    rose_trace_end("output_frame");
+}
+
+static int
+rose_handle_event_output_frame_scheduler_timer_expiry(void* data) {
+    // Obtain the output.
+    struct rose_output* output = data;
+
+    // Clear the flag.
+    output->frame_scheduler.is_frame_pending = false;
+
+    // Process the delayed frame.
+    rose_trace_begin("output_frame");
+    rose_output_process_frame(output);
+    rose_trace_end("output_frame");
+
+    return 0;
+}
+
+static int
+rose_handle_event_output_frame_done_throttling_timer_expiry(void* data) {
+    // Obtain the output.
+    struct rose_output* output = data;
+
+    // Clear the flag.
+    output->frame_done_throttling.is_timer_armed = false;
+
+    // Get current timestamp.
+    struct timespec timestamp = {};
+    clock_gettime(CLOCK_MONOTONIC, &timestamp);
+
+    // Send throttled frame done events, and re-arm the timer if there are
+    // surfaces which can not be seen.
+    if(rose_output_send_throttled_frame_done(output, &timestamp)) {
+        rose_output_frame_done_throttling_timer_arm(output);
+    }
+
+    return 0;
+}
+
+static int
+rose_handle_event_output_frame_done_timer_expiry(void* data) {
+    // Obtain the output.
+    struct rose_output* output = data;
+
+    // Clear timer's deadline.
+    output->frame_scheduler.frame_done_deadline = 0;
+
+    // Get current timestamp.
+    struct timespec timestamp = {};
+    clock_gettime(CLOCK_MONOTONIC, &timestamp);
+
+    // Send delayed frame done events whose time has come.
+    rose_trace_begin("output_frame_done");
+    rose_output_for_each_visible_surface(
+        output, rose_output_surface_frame_done_flush, &timestamp);
+    rose_trace_end("output_frame_done");
+
+    return 0;
+}
+
 static void
 rose_handle_event_output_needs_frame(struct wl_listener* listener, void* data) {
     unused_(data);
@@ -786,6 +1623,25 @@ rose_handle_event_output_needs_frame(struct wl_listener* listener, void* data) {
         (wlr_output_schedule_frame(output->device), true);
 }
 
+static void
+rose_handle_event_output_present(struct wl_listener* listener, void* data) {
+    // Obtain the event.
+    struct wlr_output_event_present* event = data;
+
+    // Obtain the output.
+    struct rose_output* output =
+        wl_container_of(listener, output, listener_present);
+
+    // Record the time of the vertical blank.
+    // Note: Presentation timestamps are obtained from the monotonic clock.
+    rose_output_frame_scheduler_record_presentation(
+        &(output->frame_scheduler),
+        ((event->presented && (event->when != NULL))
+             ? rose_output_convert_time(event->when)
+             : 0),
+        ((event->refresh > 0) ? (uint64_t)(event->refresh) : 0));
+}
+
 static void
 rose_handle_event_output_commit(struct wl_listener* listener, void* data) {
     // Obtain the event.
@@ -826,7 +1682,7 @@ rose_handle_event_output_damage(struct wl_listener* listener, void* data) {
     struct wlr_output_event_damage* event = data;
 
     // Damage the output.
-    rose_output_add_damage(output, rose_output_damage_construct(event->damage));
+    rose_output_add_damage_region(output, event->damage);
 }
 
 static void
@@ -954,6 +1810,49 @@ rose_output_initialize(
         }
     }
 
+    // Initialize output's damage tracker.
+    for(ptrdiff_t i = 0; i != array_size_(output->damage_tracker.regions);
+        ++i) {
+        pixman_region32_init(&(output->damage_tracker.regions[i]));
+    }
+
+    output->damage_tracker.rectangle_count_max =
+        rose_output_damage_rectangle_count_default;
+
+    // Initialize output's frame scheduler.
+    // Note: If its timers can not be created, then frames and frame done events
+    // are never delayed. If renderer's timer can not be created, then only CPU
+    // time is used in prediction of rendering time.
+    rose_output_frame_scheduler_initialize(&(output->frame_scheduler));
+    output->frame_scheduler.render_timer =
+        wlr_render_timer_create(context->renderer);
+
+    output->frame_scheduler.timer = wl_event_loop_add_timer(
+        context->event_loop,
+        rose_handle_event_output_frame_scheduler_timer_expiry, output);
+
+    output->frame_scheduler.frame_done_timer = wl_event_loop_add_timer(
+        context->event_loop, rose_handle_event_output_frame_done_timer_expiry,
+        output);
+
+    // Initialize throttling of frame done events.
+    // Note: If its timer can not be created, then the surfaces which can not be
+    // seen receive no frame done events.
+    output->frame_done_throttling.interval =
+        rose_output_frame_done_throttling_interval_default;
+
+    output->frame_done_throttling.timer = wl_event_loop_add_timer(
+        context->event_loop,
+        rose_handle_event_output_frame_done_throttling_timer_expiry, output);
+
+    // Initialize output's glyph atlas and glyph storage.
+    // Note: If this fails, then the title and the menu are rendered using
+    // rasters.
+    output->glyphs.atlas = rose_glyph_atlas_initialize(context->renderer);
+    output->glyphs.title = rose_glyph_atlas_text_initialize(1);
+    output->glyphs.menu =
+        rose_glyph_atlas_text_initialize(rose_ui_menu_line_max_count);
+
     // Initialize output's list of workspaces.
     wl_list_init(&(output->workspaces));
 
@@ -992,6 +1891,7 @@ rose_output_initialize(
     // Register and initialize listeners.
     add_signal_(frame);
     add_signal_(needs_frame);
+    add_signal_(present);
 
     add_signal_(commit);
     add_signal_(damage);
@@ -1051,13 +1951,54 @@ rose_output_destroy(struct rose_output* output) {
         x->id--, rose_output_request_rasters_update(x);
     }
 
+    // Cancel asynchronous glyph rendering.
+    if(output->context->text_rendering_worker != NULL) {
+        rose_text_rendering_worker_cancel(
+            output->context->text_rendering_worker, output);
+    }
+
     // Destroy output's rasters.
-    rose_raster_destroy(output->rasters.title);
-    rose_raster_destroy(output->rasters.menu);
+    // Note: Rasters are returned to the pool.
+    rose_output_title_cache_destroy(
+        &(output->rasters.title_cache), output->context->raster_pool);
+
+    rose_raster_pool_release(
+        output->context->raster_pool, output->rasters.menu);
+
+    // Destroy output's glyph atlas and glyph storage.
+    rose_glyph_atlas_destroy(output->glyphs.atlas);
+    rose_glyph_atlas_text_destroy(output->glyphs.title);
+    rose_glyph_atlas_text_destroy(output->glyphs.menu);
+
+    // Destroy output's damage tracker.
+    for(ptrdiff_t i = 0; i != array_size_(output->damage_tracker.regions);
+        ++i) {
+        pixman_region32_fini(&(output->damage_tracker.regions[i]));
+    }
+
+    // Destroy output's frame scheduler's timers.
+    if(output->frame_scheduler.timer != NULL) {
+        wl_event_source_remove(output->frame_scheduler.timer);
+    }
+
+    if(output->frame_scheduler.frame_done_timer != NULL) {
+        wl_event_source_remove(output->frame_scheduler.frame_done_timer);
+    }
+
+    // Destroy frame scheduler's renderer timer.
+    if(output->frame_scheduler.render_timer != NULL) {
+        wlr_render_timer_destroy(output->frame_scheduler.render_timer);
+    }
+
+    // Destroy the timer of frame done event throttling.
+    if(output->frame_done_throttling.timer != NULL) {
+        wl_event_source_remove(output->frame_done_throttling.timer);
+    }
 
     // Remove listeners from signals.
     remove_signal_(frame);
     remove_signal_(needs_frame);
+    remove_signal_(present);
 
     remove_signal_(commit);
     remove_signal_(damage);
@@ -1066,6 +2007,9 @@ rose_output_destroy(struct rose_output* output) {
     remove_signal_(cursor_surface_destroy);
     remove_signal_(cursor_drag_and_drop_surface_destroy);
 
+    // Destroy output's layers.
+    rose_output_layer_set_destroy(&(output->layers));
+
     // Destroy the cursor.
     wlr_cursor_destroy(output->cursor.underlying);
 
@@ -1274,6 +2218,57 @@ rose_output_configure(
     return result;
 }
 
+bool
+rose_output_configure_damage_rectangle_limit(
+    struct rose_output* output, unsigned limit) {
+    // Validate the limit.
+    if((limit == 0) || (limit > rose_output_damage_rectangle_count_max)) {
+        return false;
+    }
+
+    // Set the limit.
+    output->damage_tracker.rectangle_count_max = (int)(limit);
+
+    // Apply it to already accumulated damage.
+    for(ptrdiff_t i = 0; i != array_size_(output->damage_tracker.regions);
+        ++i) {
+        rose_output_damage_region_limit(
+            &(output->damage_tracker.regions[i]),
+            output->damage_tracker.rectangle_count_max);
+    }
+
+    return true;
+}
+
+bool
+rose_output_configure_frame_scheduler(
+    struct rose_output* output,
+    struct rose_output_frame_scheduler_parameters parameters) {
+    return rose_output_frame_scheduler_configure(
+        &(output->frame_scheduler), parameters);
+}
+
+bool
+rose_output_configure_frame_done_throttling(
+    struct rose_output* output, unsigned interval) {
+    // Validate the interval.
+    if((interval < rose_output_frame_done_throttling_interval_min) ||
+       (interval > rose_output_frame_done_throttling_interval_max)) {
+        return false;
+    }
+
+    // Set the interval.
+    output->frame_done_throttling.interval = interval;
+
+    // Re-arm the timer with the new interval, if needed.
+    if(output->frame_done_throttling.is_timer_armed) {
+        wl_event_source_timer_update(
+            output->frame_done_throttling.timer, (int)(interval));
+    }
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Workspace focusing interface implementation.
 ////////////////////////////////////////////////////////////////////////////////
@@ -1474,62 +2469,81 @@ rose_output_remove_workspace(
 // Damage handling interface implementation.
 ////////////////////////////////////////////////////////////////////////////////
 
-struct rose_output_damage
-rose_output_consume_damage(struct rose_output* output, int buffer_age) {
-#define array_size_(a) ((ptrdiff_t)(sizeof(a) / sizeof((a)[0])))
-
+void
+rose_output_consume_damage(
+    struct rose_output* output, int buffer_age, pixman_region32_t* result,
+    pixman_region32_t* frame_damage) {
     // Obtain damage array's size.
     ptrdiff_t const damage_array_size =
-        array_size_(output->damage_tracker.damage);
-
-    // Initialize an empty result.
-    struct rose_output_damage result = {};
-
-    // Obtain damage for the given age.
-    if((buffer_age > 0) && (buffer_age < damage_array_size)) {
-        // If the given age is inside the range, then obtain and transform
-        // corresponding damage.
-        result = rose_output_damage_transform(
-            output->damage_tracker.damage[buffer_age],
-            rose_output_state_obtain(output));
-    } else {
-        // If the given age is outside the range, then set the entire output's
-        // area as the resulting damage.
-        result.width = output->device->width;
-        result.height = output->device->height;
+        array_size_(output->damage_tracker.regions);
+
+    // Compute damaged region for the given age.
+    if(result != NULL) {
+        if((buffer_age > 0) && (buffer_age < damage_array_size)) {
+            // If the given age is inside the range, then obtain corresponding
+            // damage.
+            rose_output_damage_region_obtain(output, buffer_age, result);
+        } else {
+            // If the given age is outside the range, then set the entire
+            // output's area as the resulting damage.
+            pixman_box32_t box = {
+                .x2 = output->device->width, .y2 = output->device->height};
+
+            pixman_region32_reset(result, &box);
+        }
+    }
+
+    // Compute the damage of the current frame.
+    if(frame_damage != NULL) {
+        rose_output_obtain_frame_damage(output, frame_damage);
     }
 
     // Shift damage in the tracker.
-    output->damage_tracker.damage[0] = (struct rose_output_damage){};
+    // Note: The first region is cleared before shifting, so that the region
+    // for buffer age N contains only the damage of the last N frames.
+    pixman_region32_clear(&(output->damage_tracker.regions[0]));
     for(ptrdiff_t i = damage_array_size - 1; i != 0; --i) {
-        output->damage_tracker.damage[i] = output->damage_tracker.damage[i - 1];
+        pixman_region32_copy(
+            &(output->damage_tracker.regions[i]),
+            &(output->damage_tracker.regions[i - 1]));
     }
+}
 
-    // Return the resulting damage.
-    return result;
+void
+rose_output_obtain_frame_damage(
+    struct rose_output* output, pixman_region32_t* result) {
+    rose_output_damage_region_obtain(output, 0, result);
+}
+
+void
+rose_output_clear_frame_damage(struct rose_output* output) {
+    // Note: The first region is used only as the damage of the current frame,
+    // regions for buffer ages are kept intact.
+    pixman_region32_clear(&(output->damage_tracker.regions[0]));
 }
 
 void
 rose_output_add_damage(
     struct rose_output* output, struct rose_output_damage damage) {
-    // Mark the output as damaged.
-    output->damage_tracker.frame_without_damage_count = 0;
+    // Initialize a region which contains the given damage.
+    pixman_region32_t region;
+    pixman_region32_init_rect(
+        &region, damage.x, damage.y, max_(damage.width, 0),
+        max_(damage.height, 0));
 
     // Add the damage.
-    for(ptrdiff_t i = 0; i != array_size_(output->damage_tracker.damage); ++i) {
-        output->damage_tracker.damage[i] = rose_output_damage_compute_union(
-            output->damage_tracker.damage[i], damage);
-    }
+    rose_output_add_damage_region(output, &region);
 
-    // Schedule a frame.
-    rose_output_schedule_frame(output);
+    // Clean-up the region.
+    pixman_region32_fini(&region);
 }
 
 void
 rose_output_add_surface_damage(
     struct rose_output* output, struct rose_surface* surface) {
-    // Initialize an empty damage.
-    struct rose_output_damage damage = {};
+    // Initialize an empty damaged region.
+    pixman_region32_t region;
+    pixman_region32_init(&region);
 
     // Obtain surface's damage.
     if((surface->state.previous.x != surface->state.current.x) ||
@@ -1539,40 +2553,47 @@ rose_output_add_surface_damage(
         int shift = ((surface->type == rose_surface_type_toplevel) ? -5 : 0);
         int stretch = ((surface->type == rose_surface_type_toplevel) ? 10 : 0);
 
-        // Damage previous surface's area.
-        damage = (struct rose_output_damage){
-            .x = surface->state.previous.x + shift,
-            .y = surface->state.previous.y + shift,
-            .width = surface->state.previous.width + stretch,
-            .height = surface->state.previous.height + stretch};
-
-        // Damage current surface's area.
-        damage = rose_output_damage_compute_union(
-            (struct rose_output_damage){
-                .x = surface->state.current.x + shift,
-                .y = surface->state.current.y + shift,
-                .width = surface->state.current.width + stretch,
-                .height = surface->state.current.height + stretch},
-            damage);
+        // Damage previous and current surface's areas.
+        // Note: The areas are added to the region separately, so that the
+        // pixels between them are not damaged.
+        struct rose_surface_state const* states[] = {
+            &(surface->state.previous), &(surface->state.current)};
+
+        for(ptrdiff_t i = 0; i != array_size_(states); ++i) {
+            // Damage the area of the surface along with its decoration.
+            pixman_region32_union_rect(
+                &region, &region, states[i]->x + shift, states[i]->y + shift,
+                max_(states[i]->width + stretch, 0),
+                max_(states[i]->height + stretch, 0));
+
+            // Damage the areas of its child entities, which move along with
+            // the toplevel surface.
+            if(surface->type == rose_surface_type_toplevel) {
+                rose_output_damage_region_add_surface_tree(
+                    &region, surface->xdg_surface, states[i]->x,
+                    states[i]->y);
+            }
+        }
     } else {
         if(surface->type != rose_surface_type_temporary) {
             // Obtain surface's damage.
-            damage = rose_output_damage_obtain(
-                (surface->type == rose_surface_type_subsurface)
-                    ? surface->subsurface->surface
-                    : surface->xdg_surface->surface);
+            wlr_surface_get_effective_damage(
+                ((surface->type == rose_surface_type_subsurface)
+                     ? surface->subsurface->surface
+                     : surface->xdg_surface->surface),
+                &region);
 
             // Add surface's offset.
-            damage.x += surface->state.current.x;
-            damage.y += surface->state.current.y;
+            pixman_region32_translate(
+                &region, surface->state.current.x, surface->state.current.y);
         } else {
             // Note: Testing showed wrong damage for temporary surfaces, so the
             // entire area is damaged.
-            damage = (struct rose_output_damage){
-                .x = surface->state.current.x,
-                .y = surface->state.current.y,
-                .width = surface->state.current.width,
-                .height = surface->state.current.height};
+            pixman_region32_union_rect(
+                &region, &region, surface->state.current.x,
+                surface->state.current.y,
+                max_(surface->state.current.width, 0),
+                max_(surface->state.current.height, 0));
         }
     }
 
@@ -1610,15 +2631,43 @@ rose_output_add_surface_damage(
 
         // Add parent surface's offset.
         if(surface != NULL) {
-            damage.x += surface->state.current.x;
-            damage.y += surface->state.current.y;
+            pixman_region32_translate(
+                &region, surface->state.current.x, surface->state.current.y);
         } else {
             break;
         }
     }
 
     // Add the damage.
-    rose_output_add_damage(output, damage);
+    rose_output_add_damage_region(output, &region);
+
+    // Clean-up the region.
+    pixman_region32_fini(&region);
+}
+
+void
+rose_output_add_surface_extent_damage(
+    struct rose_output* output, struct rose_surface* surface) {
+    // Initialize a region which contains surface's area along with its
+    // decoration.
+    // Note: Surface's area is taken from its state, since its buffer might have
+    // already been released.
+    pixman_region32_t region;
+    pixman_region32_init_rect(
+        &region, surface->state.current.x - 5, surface->state.current.y - 5,
+        max_(surface->state.current.width + 10, 0),
+        max_(surface->state.current.height + 10, 0));
+
+    // Add areas of surface's child entities.
+    rose_output_damage_region_add_surface_tree(
+        &region, surface->xdg_surface, surface->state.current.x,
+        surface->state.current.y);
+
+    // Add the damage.
+    rose_output_add_damage_region(output, &region);
+
+    // Clean-up the region.
+    pixman_region32_fini(&region);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -6,7 +6,11 @@
 #ifndef H_0DF3C518ADEA43DB9AA264FB4CF22816
 #define H_0DF3C518ADEA43DB9AA264FB4CF22816
 
+#include "device_output_frame_scheduler.h"
+#include "device_output_layer.h"
 #include "device_output_ui.h"
+#include "metrics.h"
+#include <pixman.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Forward declarations.
@@ -15,6 +19,9 @@
 struct rose_raster;
 struct rose_server_context;
 
+struct rose_glyph_atlas;
+struct rose_glyph_atlas_text;
+
 struct rose_surface;
 struct rose_workspace;
 
@@ -24,6 +31,59 @@ struct wlr_surface;
 struct wlr_output;
 struct wlr_output_layout;
 
+////////////////////////////////////////////////////////////////////////////////
+// Output's title raster cache definition.
+//
+// Note: Cache holds recently rendered titles of surfaces, so that refocusing
+// a recently focused surface requires neither text rendering nor texture
+// upload. Entries are keyed by all parameters which affect rendered pixels,
+// stale entries of destroyed surfaces are eventually evicted.
+////////////////////////////////////////////////////////////////////////////////
+
+enum { rose_output_title_cache_size = 8 };
+
+struct rose_output_title_cache_key {
+    // Focused surface and the hash of composed title string.
+    struct rose_surface* surface;
+    uint64_t title_hash;
+
+    // Raster's dimensions and text rendering parameters.
+    int width, height, font_size, dpi;
+    unsigned char color[4];
+};
+
+struct rose_output_title_cache_entry {
+    // Entry's key.
+    struct rose_output_title_cache_key key;
+
+    // Rendered title.
+    struct rose_raster* raster;
+
+    // Time of the last use (zero if the entry is empty).
+    unsigned long long last_use_time;
+};
+
+struct rose_output_title_cache {
+    struct rose_output_title_cache_entry
+        entries[rose_output_title_cache_size];
+
+    unsigned long long time;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Output's glyph rendering state definition.
+//
+// Note: Glyphs of output's texts which are not in the glyph cache are rendered
+// by the text rendering worker, and the update of these texts is postponed
+// until the rendering finishes. Then the texts are rendered from the cache.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_output_glyph_rendering_state {
+    rose_output_glyph_rendering_state_idle,
+    rose_output_glyph_rendering_state_pending,
+    rose_output_glyph_rendering_state_finished
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Output mode definition.
 ////////////////////////////////////////////////////////////////////////////////
@@ -51,6 +111,14 @@ struct rose_output_damage {
     int x, y, width, height;
 };
 
+// Default and maximum limits on the number of rectangles in output's damaged
+// region. If the region consists of more rectangles, then it is replaced with
+// its bounding box.
+enum {
+    rose_output_damage_rectangle_count_default = 16,
+    rose_output_damage_rectangle_count_max = 256
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Output's adaptive sync state definition.
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,6 +148,51 @@ enum rose_output_cursor_type {
     rose_output_cursor_type_count_
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Output's direct scan-out status definition.
+//
+// Note: Status shows whether the output has been put in direct scan-out mode,
+// and if it has not, then why.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_output_scan_out_status {
+    // Output has been put in direct scan-out mode.
+    rose_output_scan_out_status_success,
+
+    // Scan-out is not possible because the screen is locked, or the output has
+    // no focused workspace.
+    rose_output_scan_out_status_screen_locked,
+    rose_output_scan_out_status_no_workspace,
+
+    // Scan-out is not possible because of visible UI components, drag and drop
+    // operation, or because the workspace is not in normal mode.
+    rose_output_scan_out_status_drag_and_drop,
+    rose_output_scan_out_status_panel_visible,
+    rose_output_scan_out_status_menu_visible,
+    rose_output_scan_out_status_widget_visible,
+    rose_output_scan_out_status_workspace_mode,
+
+    // Scan-out is not possible because of the state of workspace's focused
+    // surface.
+    // Note: Subsurfaces prevent scan-out if they can not be placed on output's
+    // layers (if they are stacked below their parent, or there are too many
+    // of them).
+    rose_output_scan_out_status_no_focused_surface,
+    rose_output_scan_out_status_no_buffer,
+    rose_output_scan_out_status_position,
+    rose_output_scan_out_status_subsurfaces,
+    rose_output_scan_out_status_popups,
+    rose_output_scan_out_status_transform_mismatch,
+    rose_output_scan_out_status_scale_mismatch,
+
+    // Scan-out has been attempted, but failed.
+    rose_output_scan_out_status_swapchain_failure,
+    rose_output_scan_out_status_test_failure,
+    rose_output_scan_out_status_commit_failure,
+    rose_output_scan_out_status_layer_rejection,
+    rose_output_scan_out_status_count_
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Output definition.
 ////////////////////////////////////////////////////////////////////////////////
@@ -94,6 +207,9 @@ struct rose_output {
     // Layout this output device belongs to.
     struct wlr_output_layout* layout;
 
+    // Layers which are used for direct scan-out of subsurfaces.
+    struct rose_output_layer_set layers;
+
     // List of available modes.
     struct rose_output_mode_list modes;
 
@@ -123,13 +239,33 @@ struct rose_output {
 
     // Damage tracker.
     struct {
-        // Damage array for different buffer ages.
-        struct rose_output_damage damage[8];
+        // Damaged regions for different buffer ages.
+        pixman_region32_t regions[8];
+
+        // Maximum number of rectangles in each region.
+        int rectangle_count_max;
 
         // Number of frames rendered without damage.
         unsigned frame_without_damage_count;
     } damage_tracker;
 
+    // Frame scheduler.
+    struct rose_output_frame_scheduler frame_scheduler;
+
+    // Throttling of frame done events which are sent to the surfaces which can
+    // not be seen: occluded surfaces, and surfaces which are not visible, or
+    // belong to non-focused workspaces.
+    struct {
+        // Timer which fires when throttled frame done events must be sent.
+        struct wl_event_source* timer;
+
+        // Interval between throttled frame done events (in milliseconds).
+        unsigned interval;
+
+        // A flag which shows that the timer is armed.
+        bool is_timer_armed;
+    } frame_done_throttling;
+
     // User interface.
     struct rose_output_ui ui;
 
@@ -142,13 +278,27 @@ struct rose_output {
     struct rose_workspace* focused_workspace;
 
     // Rasters for the focused surface's title and the menu.
+    // Note: Title's raster is owned by the title cache.
     struct {
         struct rose_raster *title, *menu;
+        struct rose_output_title_cache title_cache;
     } rasters;
 
+    // Glyph atlas, and glyphs of the focused surface's title and the menu.
+    // Note: If the glyphs are valid, then they are rendered from the atlas
+    // instead of the corresponding rasters.
+    struct {
+        struct rose_glyph_atlas* atlas;
+        struct rose_glyph_atlas_text *title, *menu;
+    } glyphs;
+
+    // State of asynchronous glyph rendering.
+    enum rose_output_glyph_rendering_state glyph_rendering_state;
+
     // Event listeners.
     struct wl_listener listener_frame;
     struct wl_listener listener_needs_frame;
+    struct wl_listener listener_present;
 
     struct wl_listener listener_commit;
     struct wl_listener listener_damage;
@@ -163,6 +313,14 @@ struct rose_output {
     // Output's ID.
     unsigned id;
 
+    // Number of frames of each type.
+    uint64_t frame_counts[rose_metrics_frame_type_count_];
+
+    // Direct scan-out status of the last rendered frame, and the number of
+    // rendered frames with each status.
+    enum rose_output_scan_out_status scan_out_status;
+    uint64_t scan_out_status_counts[rose_output_scan_out_status_count_];
+
     // Flags.
     bool is_scanned_out, is_frame_scheduled, is_rasters_update_requested;
 };
@@ -209,6 +367,14 @@ enum rose_output_configuration_type {
 // rose_output_configuration_type enumeration.
 typedef unsigned rose_output_configuration_mask;
 
+// Default, minimum and maximum intervals between throttled frame done events
+// (in milliseconds).
+enum {
+    rose_output_frame_done_throttling_interval_default = 1000,
+    rose_output_frame_done_throttling_interval_min = 10,
+    rose_output_frame_done_throttling_interval_max = 60000
+};
+
 struct rose_output_configuration_parameters {
     // Output's configuration flags.
     rose_output_configuration_mask flags;
@@ -256,6 +422,23 @@ rose_output_configure(
     struct rose_output* output,
     struct rose_output_configuration_parameters parameters);
 
+// Sets the maximum number of rectangles in output's damaged region. Returns
+// false if the limit is out of range.
+bool
+rose_output_configure_damage_rectangle_limit(
+    struct rose_output* output, unsigned limit);
+
+bool
+rose_output_configure_frame_scheduler(
+    struct rose_output* output,
+    struct rose_output_frame_scheduler_parameters parameters);
+
+// Sets the interval between frame done events which are sent to the surfaces
+// which can not be seen. Returns false if the interval is out of range.
+bool
+rose_output_configure_frame_done_throttling(
+    struct rose_output* output, unsigned interval);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Workspace focusing interface.
 ////////////////////////////////////////////////////////////////////////////////
@@ -284,10 +467,29 @@ rose_output_remove_workspace(
 // Damage handling interface.
 ////////////////////////////////////////////////////////////////////////////////
 
-// Returns damage for the given buffer age and shifts damage array in a single
-// operation.
-struct rose_output_damage
-rose_output_consume_damage(struct rose_output* output, int buffer_age);
+// Computes damaged region in output buffer's coordinates for the given buffer
+// age, and the damage of the current frame (the region which has been damaged
+// since the previous frame), and shifts damage array in a single operation.
+// The resulting regions must be initialized by the caller. If any of them is
+// NULL, then it is not computed; if both are NULL, then damage array is only
+// shifted.
+void
+rose_output_consume_damage(
+    struct rose_output* output, int buffer_age, pixman_region32_t* result,
+    pixman_region32_t* frame_damage);
+
+// Computes the damage of the current frame in output buffer's coordinates. The
+// resulting region must be initialized by the caller.
+void
+rose_output_obtain_frame_damage(
+    struct rose_output* output, pixman_region32_t* result);
+
+// Clears the damage of the current frame without shifting damage array. Must be
+// used after committing the frames which have not been rendered to the buffers
+// of output's swapchain (e.g., directly scanned-out frames), since such frames
+// do not change the ages of these buffers.
+void
+rose_output_clear_frame_damage(struct rose_output* output);
 
 void
 rose_output_add_damage(
@@ -297,6 +499,12 @@ void
 rose_output_add_surface_damage(
     struct rose_output* output, struct rose_surface* surface);
 
+// Damages the area which is occupied by the given toplevel surface, its child
+// entities and its decoration.
+void
+rose_output_add_surface_extent_damage(
+    struct rose_output* output, struct rose_surface* surface);
+
 ////////////////////////////////////////////////////////////////////////////////
 // State manipulation interface.
 ////////////////////////////////////////////////////////////////////////////////
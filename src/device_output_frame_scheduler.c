@@ -0,0 +1,221 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "device_output_frame_scheduler.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t
+rose_output_frame_scheduler_obtain_refresh_period(
+    struct rose_output_frame_scheduler const* scheduler,
+    uint64_t refresh_period) {
+    // Note: If output's refresh period is unknown (e.g., with adaptive sync),
+    // then the reported one is not used.
+    if((refresh_period == 0) ||
+       (scheduler->presentation_refresh_period == 0)) {
+        return refresh_period;
+    }
+
+    return scheduler->presentation_refresh_period;
+}
+
+static uint64_t
+rose_output_frame_scheduler_compute_offset(
+    struct rose_output_frame_scheduler const* scheduler,
+    uint64_t refresh_period) {
+    // Start rendering immediately if there is nothing to base the offset on.
+    if(!(scheduler->parameters.is_enabled) || (refresh_period == 0) ||
+       (scheduler->rendering_times.count == 0)) {
+        return 0;
+    }
+
+    // Compute the time which is required to render a frame.
+    uint64_t budget =
+        rose_output_frame_time_history_predict(&(scheduler->rendering_times)) +
+        (uint64_t)(scheduler->parameters.safety_margin) * 1000;
+
+    // Start rendering immediately if the frame can not be rendered in time
+    // otherwise.
+    if(budget >= refresh_period) {
+        return 0;
+    }
+
+    // Compute the offset of the start of rendering from the frame event.
+    return refresh_period - budget;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame time history manipulation interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_output_frame_time_history_record(
+    struct rose_output_frame_time_history* history, uint64_t time) {
+    // Overwrite the oldest measurement.
+    history->times[history->index] = time;
+    history->index =
+        (history->index + 1) % rose_output_frame_time_history_size;
+
+    // Update the number of measurements.
+    if(history->count != rose_output_frame_time_history_size) {
+        history->count++;
+    }
+}
+
+uint64_t
+rose_output_frame_time_history_predict(
+    struct rose_output_frame_time_history const* history) {
+    // Note: The prediction is pessimistic, since missing a deadline costs a
+    // whole refresh cycle, while overestimation only costs a fraction of it.
+    uint64_t result = 0;
+    for(size_t i = 0; i != history->count; ++i) {
+        if(history->times[i] > result) {
+            result = history->times[i];
+        }
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_output_frame_scheduler_initialize(
+    struct rose_output_frame_scheduler* scheduler) {
+    *scheduler = (struct rose_output_frame_scheduler){
+        .parameters = {
+            .safety_margin = rose_output_frame_scheduler_safety_margin_default,
+            .is_enabled = true}};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Configuration interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+bool
+rose_output_frame_scheduler_configure(
+    struct rose_output_frame_scheduler* scheduler,
+    struct rose_output_frame_scheduler_parameters parameters) {
+    // Validate the parameters.
+    if(parameters.safety_margin >
+       rose_output_frame_scheduler_safety_margin_max) {
+        return false;
+    }
+
+    // Set the parameters.
+    return (scheduler->parameters = parameters), true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Measurement interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_output_frame_scheduler_record_rendering_time(
+    struct rose_output_frame_scheduler* scheduler, uint64_t time) {
+    rose_output_frame_time_history_record(&(scheduler->rendering_times), time);
+}
+
+uint64_t
+rose_output_frame_scheduler_predict_rendering_time(
+    struct rose_output_frame_scheduler const* scheduler) {
+    return rose_output_frame_time_history_predict(
+        &(scheduler->rendering_times));
+}
+
+void
+rose_output_frame_scheduler_record_presentation(
+    struct rose_output_frame_scheduler* scheduler, uint64_t time,
+    uint64_t refresh_period) {
+    scheduler->presentation_time = time;
+    scheduler->presentation_refresh_period = refresh_period;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Scheduling interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned
+rose_output_frame_scheduler_compute_delay(
+    struct rose_output_frame_scheduler const* scheduler,
+    uint64_t refresh_period, uint64_t time) {
+    // Obtain the refresh period, and the offset of the start of rendering from
+    // the vertical blank.
+    refresh_period = rose_output_frame_scheduler_obtain_refresh_period(
+        scheduler, refresh_period);
+
+    uint64_t offset =
+        rose_output_frame_scheduler_compute_offset(scheduler, refresh_period);
+
+    // Start rendering immediately if it is not delayed, or if the frame event
+    // does not follow the last vertical blank.
+    uint64_t vblank_time = scheduler->presentation_time;
+    if((offset == 0) || (vblank_time == 0) || (time < vblank_time) ||
+       ((time - vblank_time) >= refresh_period)) {
+        return 0;
+    }
+
+    // Start rendering immediately if its start time has already passed.
+    uint64_t start_time = vblank_time + offset;
+    if(start_time <= time) {
+        return 0;
+    }
+
+    // Note: The delay is rounded down, since timers have millisecond
+    // resolution.
+    return (unsigned)((start_time - time) / 1000000);
+}
+
+uint64_t
+rose_output_frame_scheduler_compute_presentation_deadline(
+    struct rose_output_frame_scheduler const* scheduler,
+    uint64_t refresh_period) {
+    // Obtain the refresh period.
+    refresh_period = rose_output_frame_scheduler_obtain_refresh_period(
+        scheduler, refresh_period);
+
+    // The deadline is unknown if there is nothing to base it on.
+    if(!(scheduler->parameters.is_enabled) || (refresh_period == 0) ||
+       (scheduler->presentation_time == 0)) {
+        return 0;
+    }
+
+    // Compute the deadline.
+    return scheduler->presentation_time + refresh_period +
+           rose_output_frame_scheduler_compute_offset(
+               scheduler, refresh_period);
+}
+
+uint64_t
+rose_output_frame_scheduler_compute_frame_done_time(
+    struct rose_output_frame_scheduler const* scheduler,
+    uint64_t refresh_period, uint64_t commit_time) {
+    // Obtain the presentation deadline.
+    uint64_t deadline =
+        rose_output_frame_scheduler_compute_presentation_deadline(
+            scheduler, refresh_period);
+
+    // Send the event immediately if there is nothing to base the delay on.
+    if((deadline == 0) || (commit_time == 0)) {
+        return 0;
+    }
+
+    // Compute the time which is required to commit a new frame.
+    uint64_t budget =
+        commit_time + (uint64_t)(scheduler->parameters.safety_margin) * 1000;
+
+    // Send the event immediately if the client can not commit in time
+    // otherwise.
+    if(budget >= deadline) {
+        return 0;
+    }
+
+    // Compute the time.
+    return deadline - budget;
+}
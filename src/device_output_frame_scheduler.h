@@ -0,0 +1,193 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_DDD8547A6EE0482D910D84180BB8EFB6
+#define H_DDD8547A6EE0482D910D84180BB8EFB6
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Forward declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+struct wl_event_source;
+struct wlr_render_timer;
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame scheduler configuration parameters definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    // Default and maximum safety margins (in microseconds).
+    rose_output_frame_scheduler_safety_margin_default = 2000,
+    rose_output_frame_scheduler_safety_margin_max = 100000
+};
+
+struct rose_output_frame_scheduler_parameters {
+    // Safety margin (in microseconds) which is added to predicted rendering
+    // time.
+    unsigned safety_margin;
+
+    // A flag which shows that rendering is delayed.
+    bool is_enabled;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame time history definition.
+//
+// Note: The history stores recently measured durations of a repeating
+// operation, such as rendering of a frame, and predicts the duration of the
+// next one.
+////////////////////////////////////////////////////////////////////////////////
+
+enum { rose_output_frame_time_history_size = 16 };
+
+struct rose_output_frame_time_history {
+    // Measured durations (in nanoseconds).
+    uint64_t times[rose_output_frame_time_history_size];
+    size_t count, index;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame scheduler definition.
+//
+// Note: When enabled, the scheduler delays rendering after output's frame
+// event, so that rendering finishes just before the next vertical blank. This
+// way the content which clients commit during the delay is presented one
+// refresh cycle earlier. The delay is computed from the time of the last
+// vertical blank (as reported by output's present event), and from the maximum
+// of recently measured rendering times.
+//
+// Note: Rendering time of a frame is the maximum of the time spent in
+// rendering operation on the CPU, and the time measured by renderer's timer,
+// which includes the time the GPU needs to finish rendering. Timer's
+// measurement is obtained before rendering the next frame.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_output_frame_scheduler {
+    // Timer which fires when the delayed frame must be processed.
+    struct wl_event_source* timer;
+
+    // Timer which fires when delayed frame done events must be sent, and the
+    // time when it fires (in nanoseconds, zero if it is not armed).
+    struct wl_event_source* frame_done_timer;
+    uint64_t frame_done_deadline;
+
+    // Time of the last vertical blank (zero if unknown), and refresh period
+    // which has been reported along with it (zero if unknown), in nanoseconds.
+    uint64_t presentation_time, presentation_refresh_period;
+
+    // Recently measured rendering times.
+    struct rose_output_frame_time_history rendering_times;
+
+    // Renderer's timer (NULL if the renderer does not support timers), and the
+    // time spent in rendering operation on the CPU (in nanoseconds) of the
+    // frame whose timer's measurement has not been obtained yet.
+    struct wlr_render_timer* render_timer;
+    uint64_t pending_rendering_time;
+
+    // A flag which shows that timer's measurement is pending.
+    bool is_render_timer_pending;
+
+    // Scheduler's parameters.
+    struct rose_output_frame_scheduler_parameters parameters;
+
+    // A flag which shows that a delayed frame is pending.
+    bool is_frame_pending;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame time history manipulation interface.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_output_frame_time_history_record(
+    struct rose_output_frame_time_history* history, uint64_t time);
+
+// Returns predicted duration (in nanoseconds), or zero if the history is empty.
+uint64_t
+rose_output_frame_time_history_predict(
+    struct rose_output_frame_time_history const* history);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Initializes the scheduler with default parameters. Does not create its
+// timers.
+void
+rose_output_frame_scheduler_initialize(
+    struct rose_output_frame_scheduler* scheduler);
+
+////////////////////////////////////////////////////////////////////////////////
+// Configuration interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Returns false if the given parameters are not valid.
+bool
+rose_output_frame_scheduler_configure(
+    struct rose_output_frame_scheduler* scheduler,
+    struct rose_output_frame_scheduler_parameters parameters);
+
+////////////////////////////////////////////////////////////////////////////////
+// Measurement interface.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_output_frame_scheduler_record_rendering_time(
+    struct rose_output_frame_scheduler* scheduler, uint64_t time);
+
+// Returns predicted rendering time of the next frame (in nanoseconds).
+uint64_t
+rose_output_frame_scheduler_predict_rendering_time(
+    struct rose_output_frame_scheduler const* scheduler);
+
+// Records output's present event. The given time is the time of the vertical
+// blank at which the frame has been presented, it is zero if the frame has not
+// been presented. The given refresh period is zero if it is unknown.
+void
+rose_output_frame_scheduler_record_presentation(
+    struct rose_output_frame_scheduler* scheduler, uint64_t time,
+    uint64_t refresh_period);
+
+////////////////////////////////////////////////////////////////////////////////
+// Scheduling interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Computes the delay (in milliseconds) between output's frame event which has
+// been received at the given time and the start of rendering, given output's
+// refresh period (in nanoseconds, zero if it is unknown, in which case the
+// reported one is not used either). Returns zero if rendering must start
+// immediately, which is the case if the scheduler is disabled, refresh period
+// is unknown, there are no measurements yet, or if the frame event does not
+// follow a vertical blank (e.g., if an idle output has been woken up).
+unsigned
+rose_output_frame_scheduler_compute_delay(
+    struct rose_output_frame_scheduler const* scheduler,
+    uint64_t refresh_period, uint64_t time);
+
+// Computes the presentation deadline (in nanoseconds): the time of the start
+// of rendering which follows the next vertical blank. Commits which arrive
+// before this time are presented at the vertical blank after the next one.
+// Returns zero if the deadline is unknown, or if the scheduler is disabled.
+uint64_t
+rose_output_frame_scheduler_compute_presentation_deadline(
+    struct rose_output_frame_scheduler const* scheduler,
+    uint64_t refresh_period);
+
+// Computes the time (in nanoseconds) when frame done event must be sent to a
+// client which needs the given time to commit a new frame after receiving this
+// event, so that the commit arrives just before the presentation deadline: the
+// time of the last vertical blank plus refresh period (plus rendering delay, if
+// any), minus the given commit time and the safety margin. Returns zero if the
+// event must be sent immediately.
+uint64_t
+rose_output_frame_scheduler_compute_frame_done_time(
+    struct rose_output_frame_scheduler const* scheduler,
+    uint64_t refresh_period, uint64_t commit_time);
+
+#endif // H_DDD8547A6EE0482D910D84180BB8EFB6
@@ -0,0 +1,153 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "device_output_layer.h"
+
+#include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_output_layer.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool
+rose_output_layer_states_are_accepted(
+    struct wlr_output_layer_state const* states, size_t size) {
+    for(size_t i = 0; i != size; ++i) {
+        if((states[i].buffer != NULL) && !(states[i].accepted)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization/destruction interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+bool
+rose_output_layer_set_reserve(
+    struct rose_output_layer_set* set, struct wlr_output* output, size_t size) {
+    // Validate the requested number of layers.
+    if(size > rose_output_layer_count_max) {
+        return false;
+    }
+
+    // Create missing layers.
+    while(set->size < size) {
+        struct wlr_output_layer* layer = wlr_output_layer_create(output);
+        if(layer == NULL) {
+            return false;
+        }
+
+        set->layers[set->size++] = layer;
+    }
+
+    // Operation succeeded.
+    return true;
+}
+
+void
+rose_output_layer_set_destroy(struct rose_output_layer_set* set) {
+    // Destroy all layers.
+    for(size_t i = 0; i != set->size; ++i) {
+        wlr_output_layer_destroy(set->layers[i]);
+    }
+
+    // Clear set's data.
+    *set = (struct rose_output_layer_set){};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Placement interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_output_layer_set_place(
+    struct rose_output_layer_set const* set,
+    struct rose_output_layer_candidate const* candidates,
+    size_t candidate_count, struct wlr_output_layer_state* states) {
+    for(size_t i = 0; i != set->size; ++i) {
+        // Disable the layer by default.
+        states[i] = (struct wlr_output_layer_state){.layer = set->layers[i]};
+
+        // Place a candidate on the layer, if any.
+        if(i < candidate_count) {
+            states[i].buffer = candidates[i].buffer;
+            states[i].src_box = candidates[i].src_box;
+            states[i].dst_box = candidates[i].dst_box;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// State manipulation interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_output_layer_set_apply(
+    struct rose_output_layer_set* set, struct wlr_output_state* state,
+    struct wlr_output_layer_state* states) {
+    // Note: If any layers are specified, then all of them must be specified.
+    if(set->size != 0) {
+        wlr_output_state_set_layers(state, states, set->size);
+    }
+}
+
+enum rose_output_layer_set_commit_status
+rose_output_layer_set_try(
+    struct rose_output_layer_set* set, struct wlr_output* output,
+    struct wlr_output_state* state,
+    struct rose_output_layer_candidate const* candidates,
+    size_t candidate_count, struct wlr_output_layer_state* states) {
+    // Create output's layers for the candidates, if needed.
+    if(!rose_output_layer_set_reserve(set, output, candidate_count)) {
+        return rose_output_layer_set_commit_status_layer_rejection;
+    }
+
+    // Place the candidates on the layers, and disable unused layers.
+    rose_output_layer_set_place(set, candidates, candidate_count, states);
+    rose_output_layer_set_apply(set, state, states);
+
+    // Test the state.
+    if(!wlr_output_test_state(output, state)) {
+        return rose_output_layer_set_commit_status_test_failure;
+    }
+
+    // If the backend has rejected any of the layers, then the candidates can
+    // not be displayed.
+    if(!rose_output_layer_states_are_accepted(states, set->size)) {
+        return rose_output_layer_set_commit_status_layer_rejection;
+    }
+
+    // Try committing the state.
+    if(!wlr_output_commit_state(output, state)) {
+        return rose_output_layer_set_commit_status_commit_failure;
+    }
+
+    // Update the state of the layers.
+    set->is_active = (candidate_count != 0);
+
+    // Operation succeeded.
+    return rose_output_layer_set_commit_status_success;
+}
+
+void
+rose_output_layer_set_disable(
+    struct rose_output_layer_set* set, struct wlr_output_state* state,
+    struct wlr_output_layer_state* states) {
+    // Do nothing if there are no active layers.
+    if(!(set->is_active)) {
+        return;
+    }
+
+    // Otherwise, remove buffers from all layers.
+    rose_output_layer_set_place(set, NULL, 0, states);
+    rose_output_layer_set_apply(set, state, states);
+
+    // Clear the flag.
+    set->is_active = false;
+}
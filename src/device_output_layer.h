@@ -0,0 +1,141 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_D62A0F4E7C3B41958E1A9B5C07F3E264
+#define H_D62A0F4E7C3B41958E1A9B5C07F3E264
+
+#include <wlr/util/box.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Forward declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+struct wlr_buffer;
+struct wlr_output;
+struct wlr_output_layer;
+struct wlr_output_layer_state;
+struct wlr_output_state;
+
+////////////////////////////////////////////////////////////////////////////////
+// Output layer set definition.
+//
+// Note: Output's layers are displayed above its primary plane, and are used for
+// direct scan-out of subsurfaces. Layers are created on demand, and are never
+// destroyed before the output.
+////////////////////////////////////////////////////////////////////////////////
+
+enum { rose_output_layer_count_max = 4 };
+
+struct rose_output_layer_set {
+    // Created layers, ordered from bottom to top.
+    struct wlr_output_layer* layers[rose_output_layer_count_max];
+    size_t size;
+
+    // A flag which shows that buffers have been committed to the layers.
+    bool is_active;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Layer candidate definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_output_layer_candidate {
+    // Buffer to display.
+    struct wlr_buffer* buffer;
+
+    // Source box in buffer-local coordinates, and destination box in
+    // output-buffer-local coordinates.
+    struct wlr_fbox src_box;
+    struct wlr_box dst_box;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Layer set commit status definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_output_layer_set_commit_status {
+    // The state has been committed, and the candidates are displayed on the
+    // layers.
+    rose_output_layer_set_commit_status_success,
+
+    // The state has not been committed because the layers could not be
+    // created, or because the backend has rejected any of the layers with
+    // buffers.
+    rose_output_layer_set_commit_status_layer_rejection,
+
+    // The state has not been committed because the backend has rejected it,
+    // or because the commit has failed.
+    rose_output_layer_set_commit_status_test_failure,
+    rose_output_layer_set_commit_status_commit_failure
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization/destruction interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Makes sure that the set contains at least the given number of layers.
+// Returns false on error.
+bool
+rose_output_layer_set_reserve(
+    struct rose_output_layer_set* set, struct wlr_output* output, size_t size);
+
+void
+rose_output_layer_set_destroy(struct rose_output_layer_set* set);
+
+////////////////////////////////////////////////////////////////////////////////
+// Placement interface.
+//
+// Note: This function does not call the backend, so its result depends only on
+// its arguments.
+////////////////////////////////////////////////////////////////////////////////
+
+// Places each of the given candidates on its own layer, in order, from bottom
+// to top, and disables the rest of the layers. Writes resulting layer states to
+// the given array, which must contain one element per layer of the set.
+//
+// Note: The number of candidates must not exceed the number of layers.
+void
+rose_output_layer_set_place(
+    struct rose_output_layer_set const* set,
+    struct rose_output_layer_candidate const* candidates,
+    size_t candidate_count, struct wlr_output_layer_state* states);
+
+////////////////////////////////////////////////////////////////////////////////
+// State manipulation interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Sets the layers of the given output state, if the set contains any layers.
+// The given array of layer states must outlive the output state.
+void
+rose_output_layer_set_apply(
+    struct rose_output_layer_set* set, struct wlr_output_state* state,
+    struct wlr_output_layer_state* states);
+
+// Tries committing the given output state along with the given candidates
+// placed on output's layers: creates missing layers, places the candidates,
+// tests the state, and commits it only if the backend has accepted all layers
+// with buffers. Updates the activity flag of the set on success. The given
+// array of layer states must outlive the output state.
+//
+// Note: The state is not committed on failure, in which case the content must
+// be composed, and the layers must be disabled with the composed frame.
+enum rose_output_layer_set_commit_status
+rose_output_layer_set_try(
+    struct rose_output_layer_set* set, struct wlr_output* output,
+    struct wlr_output_state* state,
+    struct rose_output_layer_candidate const* candidates,
+    size_t candidate_count, struct wlr_output_layer_state* states);
+
+// Disables all layers in the given output state, if any layer is active. The
+// given array of layer states must outlive the output state.
+void
+rose_output_layer_set_disable(
+    struct rose_output_layer_set* set, struct wlr_output_state* state,
+    struct wlr_output_layer_state* states);
+
+#endif // H_D62A0F4E7C3B41958E1A9B5C07F3E264
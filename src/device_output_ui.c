@@ -459,9 +459,9 @@ rose_output_ui_remove_surface(
     // Send output leave event to the surface.
     rose_surface_output_leave(surface, ui->output);
 
-    // Request output's redraw.
+    // Damage surface's area.
     if(rose_output_ui_is_surface_visible(ui, surface)) {
-        rose_output_request_redraw(ui->output);
+        rose_output_add_surface_extent_damage(ui->output, surface);
     }
 
     // Sever all links between the surface and the UI.
@@ -582,9 +582,15 @@ rose_output_ui_notify_surface_map(
         }
     }
 
-    // Request output's redraw.
+    // Damage the output.
+    // Note: The area of a toplevel surface is known, the areas of its child
+    // entities might not be known after they are unmapped.
     if(rose_output_ui_is_surface_visible(ui, surface)) {
-        rose_output_request_redraw(ui->output);
+        if(surface->type == rose_surface_type_toplevel) {
+            rose_output_add_surface_extent_damage(ui->output, surface);
+        } else {
+            rose_output_request_redraw(ui->output);
+        }
     }
 }
 
@@ -602,9 +608,13 @@ rose_output_ui_notify_surface_unmap(
         return;
     }
 
-    // Request output's redraw.
+    // Damage the output.
     if(rose_output_ui_is_surface_visible(ui, surface)) {
-        rose_output_request_redraw(ui->output);
+        if(surface->type == rose_surface_type_toplevel) {
+            rose_output_add_surface_extent_damage(ui->output, surface);
+        } else {
+            rose_output_request_redraw(ui->output);
+        }
     }
 
     // Handle the toplevel surface.
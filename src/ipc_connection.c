@@ -450,6 +450,11 @@ rose_ipc_connection_initialize(
         &(connection->container->connections[rose_ipc_connection_type_none]),
         &(connection->link));
 
+    // Update the number of open connections.
+    rose_metrics_gauge_add(
+        &(connection->context->metrics),
+        rose_metrics_gauge_type_ipc_connections, 1);
+
     // Initialize connection's IO context.
     if(true) {
         struct rose_ipc_io_context_parameters io_context_parameters = {
@@ -457,7 +462,8 @@ rose_ipc_connection_initialize(
             .event_loop = parameters.context->event_loop,
             .rx_callback_fn = rose_ipc_connection_handle_rx,
             .tx_callback_fn = rose_ipc_connection_handle_tx,
-            .external_context = connection};
+            .external_context = connection,
+            .metrics = &(parameters.context->metrics)};
 
         if(!rose_ipc_io_context_initialize(
                &(connection->io_context), io_context_parameters)) {
@@ -490,6 +496,11 @@ rose_ipc_connection_destroy(struct rose_ipc_connection* connection) {
     // Remove connection from the list.
     wl_list_remove(&(connection->link));
 
+    // Update the number of open connections.
+    rose_metrics_gauge_add(
+        &(connection->context->metrics),
+        rose_metrics_gauge_type_ipc_connections, -1);
+
     // Remove watchdog timer, if any.
     if(connection->watchdog_timer != NULL) {
         wl_event_source_remove(connection->watchdog_timer);
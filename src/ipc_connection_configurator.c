@@ -5,7 +5,11 @@
 //
 #include "server_context.h"
 #include "ipc_connection.h"
+#include "trace.h"
 
+#include <unistd.h>
+
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -50,7 +54,25 @@ enum rose_ipc_configuration_request_type {
     rose_ipc_configuration_request_type_set_output_state,
 
     // Server state update.
-    rose_ipc_configuration_request_type_update_server_state
+    rose_ipc_configuration_request_type_update_server_state,
+
+    // Output's damaged region's rectangle limit setting.
+    rose_ipc_configuration_request_type_set_output_damage_limit,
+
+    // Performance metrics query.
+    rose_ipc_configuration_request_type_obtain_metrics,
+
+    // Tracing state setting.
+    rose_ipc_configuration_request_type_set_tracing_state,
+
+    // Output's direct scan-out state query.
+    rose_ipc_configuration_request_type_obtain_output_scan_out_state,
+
+    // Output's frame scheduling setting.
+    rose_ipc_configuration_request_type_set_output_frame_scheduling,
+
+    // Output's frame done event throttling setting.
+    rose_ipc_configuration_request_type_set_output_frame_throttling
 };
 
 enum rose_ipc_configuration_result {
@@ -201,6 +223,16 @@ rose_ipc_buffer_write_double(struct rose_ipc_buffer* buffer, double x) {
     define_write_;
 }
 
+static void
+rose_ipc_buffer_write_uint64(struct rose_ipc_buffer* buffer, uint64_t x) {
+    define_write_;
+}
+
+static void
+rose_ipc_buffer_write_int64(struct rose_ipc_buffer* buffer, int64_t x) {
+    define_write_;
+}
+
 #undef define_write_
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -289,7 +321,19 @@ rose_ipc_connection_dispatch_configuration_request(
         rose_ipc_serialized_size_device_descriptor +
             rose_ipc_serialized_size_output_configuration_parameters,
         // rose_ipc_configuration_request_type_update_server_state
-        1};
+        1,
+        // rose_ipc_configuration_request_type_set_output_damage_limit
+        2 * sizeof(unsigned),
+        // rose_ipc_configuration_request_type_obtain_metrics
+        0,
+        // rose_ipc_configuration_request_type_set_tracing_state
+        1,
+        // rose_ipc_configuration_request_type_obtain_output_scan_out_state
+        sizeof(unsigned),
+        // rose_ipc_configuration_request_type_set_output_frame_scheduling
+        sizeof(unsigned) + 1 + sizeof(unsigned),
+        // rose_ipc_configuration_request_type_set_output_frame_throttling
+        2 * sizeof(unsigned)};
 
     // Obtain the server context.
     struct rose_server_context* context = connection->context;
@@ -589,6 +633,230 @@ rose_ipc_connection_dispatch_configuration_request(
 
             break;
 
+        case rose_ipc_configuration_request_type_set_output_damage_limit: {
+            // Obtain an output with the requested ID.
+            struct rose_output* output = rose_server_context_obtain_output(
+                context, rose_ipc_buffer_ref_read_uint(&request));
+
+            // Read the maximum number of rectangles in the damaged region.
+            unsigned limit = rose_ipc_buffer_ref_read_uint(&request);
+
+            // Respond with failure if there is no such output.
+            if(output == NULL) {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_device_not_found);
+
+                break;
+            }
+
+            // Set the limit and write operation's result.
+            if(rose_output_configure_damage_rectangle_limit(output, limit)) {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_success);
+            } else {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_failure);
+            }
+
+            break;
+        }
+
+        case rose_ipc_configuration_request_type_obtain_metrics: {
+            // Obtain the metrics.
+            struct rose_metrics* metrics = &(context->metrics);
+
+            // Write operation's result.
+            rose_ipc_buffer_write_byte(
+                &response, rose_ipc_configuration_result_success);
+
+            // Write the counters.
+            rose_ipc_buffer_write_uint(
+                &response, rose_metrics_counter_type_count_);
+
+            for(size_t i = 0; i != rose_metrics_counter_type_count_; ++i) {
+                rose_ipc_buffer_write_uint64(&response, metrics->counters[i]);
+            }
+
+            // Write the gauges.
+            rose_ipc_buffer_write_uint(
+                &response, rose_metrics_gauge_type_count_);
+
+            for(size_t i = 0; i != rose_metrics_gauge_type_count_; ++i) {
+                rose_ipc_buffer_write_int64(&response, metrics->gauges[i]);
+            }
+
+            // Write the histograms.
+            rose_ipc_buffer_write_uint(
+                &response, rose_metrics_histogram_type_count_);
+
+            for(size_t i = 0; i != rose_metrics_histogram_type_count_; ++i) {
+                struct rose_metrics_histogram* histogram =
+                    &(metrics->histograms[i]);
+
+                // Write histogram's buckets: upper bounds and counts.
+                rose_ipc_buffer_write_uint(
+                    &response, rose_metrics_histogram_bucket_count);
+
+                for(size_t j = 0; j != rose_metrics_histogram_bucket_count;
+                    ++j) {
+                    rose_ipc_buffer_write_uint64(
+                        &response, rose_metrics_histogram_bucket_bound_obtain(
+                                       i, j));
+
+                    rose_ipc_buffer_write_uint64(
+                        &response, histogram->buckets[j]);
+                }
+
+                // Write the total number and sum of observed values.
+                rose_ipc_buffer_write_uint64(&response, histogram->count);
+                rose_ipc_buffer_write_uint64(&response, histogram->sum);
+            }
+
+            // Write the number of outputs.
+            rose_ipc_buffer_write_uint(
+                &response,
+                cast_(unsigned, wl_list_length(&(context->outputs))));
+
+            // Write the number of frames of each type for each output.
+            struct rose_output* output = NULL;
+            wl_list_for_each(output, &(context->outputs), link) {
+                rose_ipc_buffer_write_uint(&response, output->id);
+
+                for(size_t i = 0; i != rose_metrics_frame_type_count_; ++i) {
+                    rose_ipc_buffer_write_uint64(
+                        &response, output->frame_counts[i]);
+                }
+            }
+
+            break;
+        }
+
+        case rose_ipc_configuration_request_type_set_tracing_state: {
+            // If requested, then start tracing, and do nothing else.
+            if(rose_ipc_buffer_ref_read_byte(&request) != 0) {
+                rose_trace_start();
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_success);
+
+                break;
+            }
+
+            // Otherwise, compute the path to the trace file.
+            char* runtime_directory = getenv("XDG_RUNTIME_DIR");
+            runtime_directory =
+                ((runtime_directory == NULL) ? "/tmp" : runtime_directory);
+
+            char path[256] = {};
+            int n = snprintf(
+                path, sizeof(path), "%s/rose.wm.%u.%i.trace.json",
+                runtime_directory, getuid(), getpid());
+
+            // Stop tracing, write the trace file, and write operation's
+            // result, followed by the path to the trace file.
+            if((n > 0) && (n < cast_(int, sizeof(path))) &&
+               rose_trace_stop(path)) {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_success);
+
+                rose_ipc_buffer_write_string(&response, path, cast_(size_t, n));
+            } else {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_failure);
+            }
+
+            break;
+        }
+
+        case rose_ipc_configuration_request_type_obtain_output_scan_out_state: {
+            // Obtain an output with the requested ID.
+            struct rose_output* output = rose_server_context_obtain_output(
+                context, rose_ipc_buffer_ref_read_uint(&request));
+
+            // Respond with failure if there is no such output.
+            if(output == NULL) {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_device_not_found);
+
+                break;
+            }
+
+            // Write operation's result.
+            rose_ipc_buffer_write_byte(
+                &response, rose_ipc_configuration_result_success);
+
+            // Write the status of output's last rendered frame.
+            rose_ipc_buffer_write_byte(&response, output->scan_out_status);
+
+            // Write the number of rendered frames with each status.
+            rose_ipc_buffer_write_uint(
+                &response, rose_output_scan_out_status_count_);
+
+            for(size_t i = 0; i != rose_output_scan_out_status_count_; ++i) {
+                rose_ipc_buffer_write_uint64(
+                    &response, output->scan_out_status_counts[i]);
+            }
+
+            break;
+        }
+
+        case rose_ipc_configuration_request_type_set_output_frame_scheduling: {
+            // Obtain an output with the requested ID.
+            struct rose_output* output = rose_server_context_obtain_output(
+                context, rose_ipc_buffer_ref_read_uint(&request));
+
+            // Read frame scheduler's configuration parameters.
+            struct rose_output_frame_scheduler_parameters parameters = {
+                .is_enabled = (rose_ipc_buffer_ref_read_byte(&request) != 0),
+                .safety_margin = rose_ipc_buffer_ref_read_uint(&request)};
+
+            // Respond with failure if there is no such output.
+            if(output == NULL) {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_device_not_found);
+
+                break;
+            }
+
+            // Configure output's frame scheduler and write operation's result.
+            if(rose_output_configure_frame_scheduler(output, parameters)) {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_success);
+            } else {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_failure);
+            }
+
+            break;
+        }
+
+        case rose_ipc_configuration_request_type_set_output_frame_throttling: {
+            // Obtain an output with the requested ID.
+            struct rose_output* output = rose_server_context_obtain_output(
+                context, rose_ipc_buffer_ref_read_uint(&request));
+
+            // Read the interval between throttled frame done events.
+            unsigned interval = rose_ipc_buffer_ref_read_uint(&request);
+
+            // Respond with failure if there is no such output.
+            if(output == NULL) {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_device_not_found);
+
+                break;
+            }
+
+            // Set the interval and write operation's result.
+            if(rose_output_configure_frame_done_throttling(output, interval)) {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_success);
+            } else {
+                rose_ipc_buffer_write_byte(
+                    &response, rose_ipc_configuration_result_failure);
+            }
+
+            break;
+        }
+
         default:
             rose_ipc_buffer_write_byte(
                 &response, rose_ipc_configuration_result_invalid_request);
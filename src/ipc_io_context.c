@@ -4,6 +4,8 @@
 // https://www.gnu.org/licenses/gpl-3.0.txt)
 //
 #include "ipc_io_context.h"
+#include "metrics.h"
+#include "trace.h"
 
 #include <sys/socket.h>
 #include <sys/ioctl.h>
@@ -72,7 +74,9 @@ rose_ipc_rx_more(struct rose_ipc_io_context* io_context) {
         .size = data_size_required - io_context->rx_packet.size};
 
     // Read data from the socket.
+    rose_trace_begin("ipc_rx");
     ssize_t n = recv(io_context->socket_fd, pass_(remainder), 0);
+    rose_trace_end("ipc_rx");
 
     // Handle IO operation's result.
     if(n == -1) {
@@ -88,6 +92,13 @@ rose_ipc_rx_more(struct rose_ipc_io_context* io_context) {
     // Update packet's size.
     io_context->rx_packet.size += (size_t)(n);
 
+    // Count received bytes.
+    if(io_context->metrics != NULL) {
+        rose_metrics_counter_add(
+            io_context->metrics, rose_metrics_counter_type_ipc_bytes_in,
+            (uint64_t)(n));
+    }
+
     // Perform computations depending on the size of received data.
     if(io_context->rx_packet.size == rose_ipc_packet_header_size) {
         // If only packet's header has been received completely, then compute
@@ -116,7 +127,9 @@ rose_ipc_rx_more(struct rose_ipc_io_context* io_context) {
 enum rose_ipc_io_result
 rose_ipc_tx_more(struct rose_ipc_io_context* io_context) {
     // Write data to the socket.
+    rose_trace_begin("ipc_tx");
     ssize_t n = write(io_context->socket_fd, pass_(io_context->tx_packet));
+    rose_trace_end("ipc_tx");
 
     // Handle IO operation's result.
     if(n == -1) {
@@ -132,6 +145,13 @@ rose_ipc_tx_more(struct rose_ipc_io_context* io_context) {
     // Update packet's remaining size.
     io_context->tx_packet.size -= (size_t)(n);
 
+    // Count sent bytes.
+    if(io_context->metrics != NULL) {
+        rose_metrics_counter_add(
+            io_context->metrics, rose_metrics_counter_type_ipc_bytes_out,
+            (uint64_t)(n));
+    }
+
     // Shift remaining data.
     memmove(
         io_context->tx_packet.data, io_context->tx_packet.data + n,
@@ -218,9 +238,11 @@ rose_handle_event_ipc_rx_data(int fd, uint32_t mask, void* data) {
             io_context->rx_packet.size = 0;
 
             // Signal operation's success.
+            rose_trace_begin("ipc_packet");
             io_context->rx_callback_fn(
                 io_context->external_context, rose_ipc_io_result_success,
                 buffer);
+            rose_trace_end("ipc_packet");
 
             // fall-through
         case rose_ipc_io_result_partial:
@@ -302,7 +324,8 @@ rose_ipc_io_context_initialize(
         .socket_fd = parameters.socket_fd,
         .rx_callback_fn = parameters.rx_callback_fn,
         .tx_callback_fn = parameters.tx_callback_fn,
-        .external_context = parameters.external_context};
+        .external_context = parameters.external_context,
+        .metrics = parameters.metrics};
 
     // Add event sources for handling IO operations.
     io_context->rx_event_source = wl_event_loop_add_fd(
@@ -8,6 +8,12 @@
 
 #include "ipc_types.h"
 
+////////////////////////////////////////////////////////////////////////////////
+// Forward declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_metrics;
+
 ////////////////////////////////////////////////////////////////////////////////
 // IPC IO result definition.
 ////////////////////////////////////////////////////////////////////////////////
@@ -49,6 +55,9 @@ struct rose_ipc_io_context {
 
     // External context, passed to the callback functions.
     void* external_context;
+
+    // Metrics which count transmitted bytes, if any.
+    struct rose_metrics* metrics;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -68,6 +77,9 @@ struct rose_ipc_io_context_parameters {
 
     // External context, passed to the callback functions.
     void* external_context;
+
+    // Metrics which count transmitted bytes, if any.
+    struct rose_metrics* metrics;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
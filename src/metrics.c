@@ -0,0 +1,112 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "metrics.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Histogram bucket definitions.
+////////////////////////////////////////////////////////////////////////////////
+
+// Upper bounds of histograms' buckets, excluding the last (unbounded) bucket.
+static uint64_t const rose_metrics_histogram_bucket_bounds
+    [rose_metrics_histogram_type_count_]
+    [rose_metrics_histogram_bucket_count - 1] = {
+        // rose_metrics_histogram_type_frame_damage_area
+        {0, 1024, 4096, 16384, 65536, 262144, 524288, 1048576, 2097152,
+         4194304, 8388608},
+        // rose_metrics_histogram_type_frame_rendering_time
+        {50000, 100000, 250000, 500000, 1000000, 2000000, 4000000, 8000000,
+         16000000, 33000000, 66000000},
+        // rose_metrics_histogram_type_transaction_duration
+        {1000000, 2000000, 4000000, 8000000, 16000000, 33000000, 66000000,
+         100000000, 200000000, 300000000, 1000000000}};
+
+////////////////////////////////////////////////////////////////////////////////
+// Update interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_metrics_counter_add(
+    struct rose_metrics* metrics, enum rose_metrics_counter_type type,
+    uint64_t value) {
+    metrics->counters[type] += value;
+}
+
+void
+rose_metrics_gauge_add(
+    struct rose_metrics* metrics, enum rose_metrics_gauge_type type,
+    int64_t value) {
+    metrics->gauges[type] += value;
+}
+
+void
+rose_metrics_histogram_observe(
+    struct rose_metrics* metrics, enum rose_metrics_histogram_type type,
+    uint64_t value) {
+    // Obtain the histogram and its bucket bounds.
+    struct rose_metrics_histogram* histogram = &(metrics->histograms[type]);
+    uint64_t const* bounds = rose_metrics_histogram_bucket_bounds[type];
+
+    // Find the bucket which contains the given value.
+    size_t i = 0;
+    while((i != (rose_metrics_histogram_bucket_count - 1)) &&
+          (value > bounds[i])) {
+        ++i;
+    }
+
+    // Update the histogram.
+    histogram->buckets[i]++;
+    histogram->count++;
+    histogram->sum += value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Workspace transaction tracking interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_metrics_transaction_start(struct rose_metrics* metrics, bool* is_running) {
+    // Do nothing if the start has already been registered.
+    if(*is_running) {
+        return;
+    }
+
+    // Update the number of running transactions.
+    rose_metrics_gauge_add(metrics, rose_metrics_gauge_type_transactions, 1);
+
+    // Set the flag.
+    *is_running = true;
+}
+
+bool
+rose_metrics_transaction_finish(
+    struct rose_metrics* metrics, bool* is_running, uint64_t duration) {
+    // Do nothing if the start has not been registered.
+    if(!(*is_running)) {
+        return false;
+    }
+
+    // Update the metrics.
+    rose_metrics_gauge_add(metrics, rose_metrics_gauge_type_transactions, -1);
+    rose_metrics_counter_add(
+        metrics, rose_metrics_counter_type_transactions, 1);
+    rose_metrics_histogram_observe(
+        metrics, rose_metrics_histogram_type_transaction_duration, duration);
+
+    // Clear the flag.
+    return (*is_running = false), true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Query interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t
+rose_metrics_histogram_bucket_bound_obtain(
+    enum rose_metrics_histogram_type type, size_t bucket_index) {
+    return ((bucket_index < (rose_metrics_histogram_bucket_count - 1))
+                ? rose_metrics_histogram_bucket_bounds[type][bucket_index]
+                : UINT64_MAX);
+}
@@ -0,0 +1,166 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_8E41C7A2D05B4F3A9C6E17B2F4D8A3C9
+#define H_8E41C7A2D05B4F3A9C6E17B2F4D8A3C9
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame type definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_metrics_frame_type {
+    // Output's content has been rendered.
+    rose_metrics_frame_type_rendered,
+
+    // Output has been put in direct scan-out mode.
+    rose_metrics_frame_type_scanned_out,
+
+    // Output's content has not been rendered.
+    rose_metrics_frame_type_skipped,
+    rose_metrics_frame_type_count_
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Counter type definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_metrics_counter_type {
+    // Number of frames of each type, summed over all outputs.
+    rose_metrics_counter_type_frames_rendered,
+    rose_metrics_counter_type_frames_scanned_out,
+    rose_metrics_counter_type_frames_skipped,
+
+    // Number of direct scan-out attempts and successes.
+    rose_metrics_counter_type_scan_out_attempts,
+    rose_metrics_counter_type_scan_out_successes,
+
+    // Number of committed workspace transactions.
+    rose_metrics_counter_type_transactions,
+
+    // Number of rasters allocated by the raster pool, number of allocations
+    // which have been avoided by reusing released rasters, and number of
+    // released rasters which have been destroyed to keep the pool within its
+    // limits.
+    rose_metrics_counter_type_raster_allocations,
+    rose_metrics_counter_type_raster_reuses,
+    rose_metrics_counter_type_raster_evictions,
+
+    // Number of bytes received and sent through IPC connections.
+    rose_metrics_counter_type_ipc_bytes_in,
+    rose_metrics_counter_type_ipc_bytes_out,
+    rose_metrics_counter_type_count_
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Gauge type definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_metrics_gauge_type {
+    // Number of open IPC connections.
+    rose_metrics_gauge_type_ipc_connections,
+
+    // Number of running workspace transactions.
+    rose_metrics_gauge_type_transactions,
+    rose_metrics_gauge_type_count_
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Histogram type definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_metrics_histogram_type {
+    // Area of the damaged region of each rendered frame (in pixels).
+    rose_metrics_histogram_type_frame_damage_area,
+
+    // Time spent rendering each frame (in nanoseconds).
+    rose_metrics_histogram_type_frame_rendering_time,
+
+    // Duration of each committed workspace transaction (in nanoseconds).
+    rose_metrics_histogram_type_transaction_duration,
+    rose_metrics_histogram_type_count_
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Histogram definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum { rose_metrics_histogram_bucket_count = 12 };
+
+struct rose_metrics_histogram {
+    // Number of observed values in each bucket.
+    // Note: Each bucket counts the values which do not exceed its upper bound,
+    // and exceed the upper bound of the previous bucket. The last bucket is
+    // unbounded.
+    uint64_t buckets[rose_metrics_histogram_bucket_count];
+
+    // Total number and sum of observed values.
+    uint64_t count, sum;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Metrics registry definition.
+//
+// Note: The registry is owned by the server context, and is updated on hot
+// paths, hence all of its metrics have fixed storage.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_metrics {
+    uint64_t counters[rose_metrics_counter_type_count_];
+    int64_t gauges[rose_metrics_gauge_type_count_];
+    struct rose_metrics_histogram
+        histograms[rose_metrics_histogram_type_count_];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Update interface.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_metrics_counter_add(
+    struct rose_metrics* metrics, enum rose_metrics_counter_type type,
+    uint64_t value);
+
+void
+rose_metrics_gauge_add(
+    struct rose_metrics* metrics, enum rose_metrics_gauge_type type,
+    int64_t value);
+
+void
+rose_metrics_histogram_observe(
+    struct rose_metrics* metrics, enum rose_metrics_histogram_type type,
+    uint64_t value);
+
+////////////////////////////////////////////////////////////////////////////////
+// Workspace transaction tracking interface.
+//
+// Note: Transaction's flag shows that its start has been registered. The end of
+// the transaction is registered only if the flag is set, regardless of how the
+// transaction finishes, so the number of running transactions is kept balanced.
+////////////////////////////////////////////////////////////////////////////////
+
+// Registers the start of a transaction, and sets its flag.
+void
+rose_metrics_transaction_start(struct rose_metrics* metrics, bool* is_running);
+
+// Registers the end of a transaction with the given duration (in nanoseconds),
+// if its flag is set, and clears the flag. Returns previous value of the flag.
+bool
+rose_metrics_transaction_finish(
+    struct rose_metrics* metrics, bool* is_running, uint64_t duration);
+
+////////////////////////////////////////////////////////////////////////////////
+// Query interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: The upper bound of the last bucket is UINT64_MAX.
+uint64_t
+rose_metrics_histogram_bucket_bound_obtain(
+    enum rose_metrics_histogram_type type, size_t bucket_index);
+
+#endif // H_8E41C7A2D05B4F3A9C6E17B2F4D8A3C9
@@ -4,16 +4,20 @@
 // https://www.gnu.org/licenses/gpl-3.0.txt)
 //
 #include "rendering.h"
+#include "rendering_glyph_atlas.h"
+#include "rendering_pixman.h"
 #include "rendering_raster.h"
 #include "server_context.h"
 
 #include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_matrix.h>
 #include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_output_layer.h>
 
 #include <wlr/types/wlr_xdg_shell.h>
 #include <wlr/types/wlr_xdg_decoration_v1.h>
 #include <wlr/types/wlr_presentation_time.h>
+#include <wlr/render/pixman.h>
 #include <wlr/render/wlr_renderer.h>
 #include <wlr/util/transform.h>
 
@@ -38,16 +42,29 @@ struct rose_rectangle {
 ////////////////////////////////////////////////////////////////////////////////
 
 struct rose_rendering_context {
-    // Current output and its damage.
+    // Current output.
     struct rose_output* output;
-    struct rose_output_damage damage;
 
-    // Scissor rectangle. Limits rendering to the damaged area.
-    pixman_region32_t scissor_rectangle;
+    // Scissor region. Limits rendering to the damaged area.
+    pixman_region32_t scissor_region;
+
+    // Current clipping region. Points either to the scissor region, or to its
+    // part which is not occluded by opaque surfaces.
+    pixman_region32_t* clip_region;
 
     // Resulting output state and active rendering pass.
     struct wlr_output_state state;
     struct wlr_render_pass* pass;
+
+    // A flag which shows that the rendering pass is measured by a timer.
+    bool is_timed;
+
+    // Output buffer's image, if the content is composed directly with pixman
+    // (software composition mode), NULL otherwise.
+    // Note: Operations which can not be performed directly fall back to the
+    // rendering pass, which executes them immediately, so the order of
+    // operations is preserved.
+    pixman_image_t* image;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -59,6 +76,31 @@ struct rose_surface_rendering_context {
     int dx, dy;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Occlusion culling-related definitions.
+////////////////////////////////////////////////////////////////////////////////
+
+// Maximum number of topmost visible surfaces which are subject to occlusion
+// culling. Surfaces which are deeper in the stack are clipped only to the
+// scissor region.
+enum { rose_occlusion_surface_count_max = 64 };
+
+struct rose_surface_visibility {
+    // Visible regions of the surface and of its decoration.
+    pixman_region32_t surface, decoration;
+};
+
+struct rose_occlusion_context {
+    // Output's state.
+    struct rose_output_state output_state;
+
+    // Regions which accumulate opaque areas and areas occupied by surfaces.
+    pixman_region32_t *opaque_region, *extent_region;
+
+    // Offset of the current surface.
+    int dx, dy;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Rendering context initialization/finalization utility functions.
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,28 +120,64 @@ rose_rendering_context_initialize(
         return wlr_output_state_finish(&(context->state)), false;
     }
 
-    // Start rendering operation, obtain current buffer age.
+    // Start rendering operation, obtain current buffer age. The operation is
+    // measured by frame scheduler's timer, if any.
+    struct wlr_buffer_pass_options options = {
+        .timer = output->frame_scheduler.render_timer};
+
     int buffer_age = -1;
     context->pass = wlr_output_begin_render_pass(
-        output->device, &(context->state), &buffer_age, NULL);
+        output->device, &(context->state), &buffer_age, &options);
+
+    context->is_timed = (context->pass != NULL) && (options.timer != NULL);
+
+    // Initialize scissor region from current damage.
+    // Note: The frame damage is committed along with the buffer, so that the
+    // backend and screen capture clients (such as wlr-screencopy clients
+    // which request a copy with damage) can process only the changed area.
+    pixman_region32_t frame_damage;
+    pixman_region32_init(&frame_damage);
+    pixman_region32_init(&(context->scissor_region));
 
-    // Consume current damage.
-    context->damage = rose_output_consume_damage(output, buffer_age);
+    rose_output_consume_damage(
+        output, buffer_age, &(context->scissor_region), &frame_damage);
 
-    // Initialize scissor rectangle.
-    pixman_region32_init_rect(
-        &(context->scissor_rectangle), //
-        context->damage.x,             //
-        context->damage.y,             //
-        context->damage.width,         //
-        context->damage.height);
+    wlr_output_state_set_damage(&(context->state), &frame_damage);
+    pixman_region32_fini(&frame_damage);
+
+    // Set the scissor region as the clipping region.
+    context->clip_region = &(context->scissor_region);
+
+    // Obtain output buffer's image, if software composition is enabled.
+    context->image = NULL;
+    if((context->pass != NULL) &&
+       output->context->is_software_composition_enabled) {
+        context->image = wlr_pixman_renderer_get_buffer_image(
+            output->context->renderer, context->state.buffer);
+    }
 
     // Initialization succeeded.
     return true;
 }
 
-static void
+static struct rose_rendering_result
 rose_rendering_context_finalize(struct rose_rendering_context* context) {
+    // Compute the area of the redrawn region.
+    struct rose_rendering_result result = {
+        .type = rose_rendering_result_type_rendered,
+        .is_timed = context->is_timed};
+
+    if(true) {
+        int n_boxes = 0;
+        pixman_box32_t* boxes =
+            pixman_region32_rectangles(&(context->scissor_region), &n_boxes);
+
+        for(int i = 0; i != n_boxes; ++i) {
+            result.damage_area += (uint64_t)(boxes[i].x2 - boxes[i].x1) *
+                                  (uint64_t)(boxes[i].y2 - boxes[i].y1);
+        }
+    }
+
     // Render software cursors.
     wlr_output_add_software_cursors_to_render_pass(
         context->output->device, context->pass, NULL);
@@ -107,14 +185,22 @@ rose_rendering_context_finalize(struct rose_rendering_context* context) {
     // Finish rendering operation.
     wlr_render_pass_submit(context->pass);
 
+    // Disable output's layers, if needed, since composed content replaces
+    // directly scanned-out subsurfaces.
+    struct wlr_output_layer_state layer_states[rose_output_layer_count_max];
+    rose_output_layer_set_disable(
+        &(context->output->layers), &(context->state), layer_states);
+
     // Commit resulting state.
     wlr_output_commit_state(context->output->device, &(context->state));
 
     // Clean-up resulting state.
     wlr_output_state_finish(&(context->state));
 
-    // Clean-up the scissor rectangle.
-    pixman_region32_fini(&(context->scissor_rectangle));
+    // Clean-up the scissor region.
+    pixman_region32_fini(&(context->scissor_region));
+
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -195,6 +281,207 @@ rose_rectangle_transform(
     return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Occlusion culling utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool
+rose_surface_is_decorated(
+    struct rose_surface* surface, struct rose_surface_state surface_state) {
+    return !(surface_state.is_maximized || surface_state.is_fullscreen) &&
+           ((surface->xdg_decoration == NULL) ||
+            (surface->xdg_decoration->current.mode ==
+             WLR_XDG_TOPLEVEL_DECORATION_V1_MODE_SERVER_SIDE));
+}
+
+static void
+rose_region_add_rectangle(
+    pixman_region32_t* region, struct rose_rectangle rectangle,
+    struct rose_output_state output_state) {
+    // Transform the rectangle.
+    rectangle = rose_rectangle_transform(rectangle, output_state);
+
+    // Add it to the region.
+    if((rectangle.width > 0) && (rectangle.height > 0)) {
+        pixman_region32_union_rect(
+            region, region, rectangle.x, rectangle.y, rectangle.width,
+            rectangle.height);
+    }
+}
+
+static void
+rose_occlusion_add_surface(
+    struct wlr_surface* surface, int x, int y, void* data) {
+    // Obtain occlusion context.
+    struct rose_occlusion_context* context = data;
+
+    // Surfaces without buffers are not rendered, hence they neither occupy nor
+    // occlude anything.
+    if(!wlr_surface_has_buffer(surface)) {
+        return;
+    }
+
+    // Compute surface's offset.
+    x += context->dx;
+    y += context->dy;
+
+    // Add surface's area to the extent region.
+    if(true) {
+        struct rose_rectangle rectangle = {
+            .x = x,
+            .y = y,
+            .width = surface->current.width,
+            .height = surface->current.height};
+
+        rose_region_add_rectangle(
+            context->extent_region, rectangle, context->output_state);
+    }
+
+    // Obtain rectangles of surface's opaque region.
+    int rectangle_count = 0;
+    pixman_box32_t const* rectangles =
+        pixman_region32_rectangles(&(surface->opaque_region), &rectangle_count);
+
+    // Add these rectangles to the opaque region.
+    for(int i = 0; i != rectangle_count; ++i) {
+        struct rose_rectangle rectangle = {
+            .x = rectangles[i].x1 + x,
+            .y = rectangles[i].y1 + y,
+            .width = rectangles[i].x2 - rectangles[i].x1,
+            .height = rectangles[i].y2 - rectangles[i].y1};
+
+        rose_region_add_rectangle(
+            context->opaque_region, rectangle, context->output_state);
+    }
+}
+
+static ptrdiff_t
+rose_compute_surface_visibility(
+    struct rose_rendering_context* context, struct rose_workspace* workspace,
+    struct rose_color_scheme const* color_scheme,
+    struct rose_surface_visibility* visibility,
+    pixman_region32_t* background_region) {
+    // Initialize empty regions.
+    pixman_region32_t opaque_region, extent_region, covered_region;
+    pixman_region32_init(&opaque_region);
+    pixman_region32_init(&extent_region);
+    pixman_region32_init(&covered_region);
+
+    // Initialize occlusion context.
+    struct rose_occlusion_context occlusion_context = {
+        .output_state = rose_output_state_obtain(context->output),
+        .opaque_region = &opaque_region,
+        .extent_region = &extent_region};
+
+    // Determine if surface decorations are opaque.
+    bool is_decoration_opaque =
+        (color_scheme->surface_background0.rgba8[3] == 0xFF) &&
+        (color_scheme->surface_background1.rgba8[3] == 0xFF);
+
+    // Iterate through the list of visible surfaces, starting from the topmost
+    // one.
+    ptrdiff_t n = 0;
+    struct rose_surface* surface = NULL;
+    wl_list_for_each_reverse(
+        surface, &(workspace->surfaces_visible), link_visible) {
+        // Limit the number of processed surfaces.
+        // Note: Surfaces which are not processed are considered not occluded.
+        if(n == rose_occlusion_surface_count_max) {
+            surface->is_occluded = false;
+            continue;
+        }
+
+        // Obtain surface's state.
+        struct rose_surface_state surface_state =
+            rose_surface_state_obtain(surface);
+
+        // Obtain surface's visibility data.
+        struct rose_surface_visibility* x = &(visibility[n++]);
+        pixman_region32_init(&(x->surface));
+        pixman_region32_init(&(x->decoration));
+
+        // Compute the part of the scissor region which is not covered by
+        // opaque surfaces above the current one.
+        pixman_region32_subtract(
+            &(x->surface), &(context->scissor_region), &opaque_region);
+
+        // Add areas of the surface and its child entities to the extent and
+        // opaque regions.
+        occlusion_context.dx = surface_state.x;
+        occlusion_context.dy = surface_state.y;
+
+        pixman_region32_copy(&covered_region, &opaque_region);
+        pixman_region32_clear(&extent_region);
+        wlr_xdg_surface_for_each_surface(
+            surface->xdg_surface, rose_occlusion_add_surface,
+            &occlusion_context);
+
+        // The surface is occluded if its area is fully covered by opaque
+        // surfaces and decorations above it.
+        // Note: The scissor region is not taken into account here, since the
+        // flag is used for throttling of surface's frame done events.
+        pixman_region32_subtract(
+            &covered_region, &extent_region, &covered_region);
+
+        surface->is_occluded = !pixman_region32_not_empty(&covered_region);
+
+        // Handle surface's decoration, if any.
+        if(rose_surface_is_decorated(surface, surface_state)) {
+            // Compute decoration's area.
+            struct rose_rectangle rectangle = {
+                .x = surface_state.x - 5,
+                .y = surface_state.y - 5,
+                .width = surface_state.width + 10,
+                .height = surface_state.height + 10};
+
+            rose_region_add_rectangle(
+                &(x->decoration), rectangle, occlusion_context.output_state);
+
+            // The decoration is visible in its area, except the parts which are
+            // covered by opaque surfaces, including the decorated surface.
+            pixman_region32_intersect(
+                &(x->decoration), &(x->decoration), &(x->surface));
+
+            pixman_region32_subtract(
+                &(x->decoration), &(x->decoration), &opaque_region);
+
+            // Add decoration's area to the opaque region, if needed.
+            if(is_decoration_opaque) {
+                rose_region_add_rectangle(
+                    &opaque_region, rectangle, occlusion_context.output_state);
+            }
+        }
+
+        // The surface is visible only in the area it occupies.
+        pixman_region32_intersect(&(x->surface), &(x->surface), &extent_region);
+    }
+
+    // The background is visible only in the areas which are not covered by
+    // opaque surfaces.
+    pixman_region32_subtract(
+        background_region, &(context->scissor_region), &opaque_region);
+
+    // Free memory.
+    pixman_region32_fini(&opaque_region);
+    pixman_region32_fini(&extent_region);
+    pixman_region32_fini(&covered_region);
+
+    // Return the number of processed surfaces.
+    return n;
+}
+
+static void
+rose_reset_surface_occlusion(
+    struct rose_workspace* workspace, struct rose_surface* visible_surface) {
+    // Mark all visible surfaces of the workspace as occluded, except the given
+    // one. If no surface is given, then no surface is considered occluded.
+    struct rose_surface* surface = NULL;
+    wl_list_for_each(surface, &(workspace->surfaces_visible), link_visible) {
+        surface->is_occluded =
+            (visible_surface != NULL) && (surface != visible_surface);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Rendering utility functions.
 ////////////////////////////////////////////////////////////////////////////////
@@ -209,7 +496,19 @@ rose_render_rectangle(
             rectangle, rose_output_state_obtain(context->output));
     }
 
-    // Render the rectangle.
+    // Fill the rectangle directly, if possible.
+    if(context->image != NULL) {
+        pixman_box32_t box = {
+            .x1 = rectangle.x,
+            .y1 = rectangle.y,
+            .x2 = rectangle.x + rectangle.width,
+            .y2 = rectangle.y + rectangle.height};
+
+        rose_pixman_fill(context->image, context->clip_region, box, color);
+        return;
+    }
+
+    // Otherwise, render the rectangle.
     struct wlr_render_rect_options options = {
         .box =
             {.x = rectangle.x,
@@ -221,15 +520,98 @@ rose_render_rectangle(
              .g = color.rgba32[1],
              .b = color.rgba32[2],
              .a = color.rgba32[3]},
-        .clip = &(context->scissor_rectangle)};
+        .clip = context->clip_region};
 
     wlr_render_pass_add_rect(context->pass, &options);
 }
 
+static bool
+rose_render_rectangle_with_texture_directly(
+    struct rose_rendering_context* context, struct wlr_texture* texture,
+    struct wlr_client_buffer* client_buffer, struct wlr_fbox* region,
+    struct rose_rectangle rectangle, bool is_texture_opaque) {
+    // Note: The given rectangle must already be transformed. Direct
+    // composition is only possible if the texture is neither transformed nor
+    // scaled, otherwise the rendering pass must be used.
+    // Note: Client buffer must be specified if the texture has been created
+    // from client's buffer, and must be NULL if the texture is owned by the
+    // compositor.
+    if(context->image == NULL) {
+        return false;
+    }
+
+    // Obtain the region of the texture which is composed.
+    struct wlr_fbox source =
+        ((region != NULL) && !wlr_fbox_empty(region)
+             ? *region
+             : (struct wlr_fbox){
+                   .width = texture->width, .height = texture->height});
+
+    // Make sure that the texture is not transformed, and that its region is
+    // pixel-aligned and has the same size as the rectangle.
+    if((rectangle.transform != WL_OUTPUT_TRANSFORM_NORMAL) ||
+       (source.x != (int)(source.x)) || (source.y != (int)(source.y)) ||
+       (source.width != rectangle.width) ||
+       (source.height != rectangle.height)) {
+        return false;
+    }
+
+    // Obtain texture's image.
+    pixman_image_t* image = wlr_pixman_texture_get_image(texture);
+
+    // If the texture has been created from client's buffer, then access to
+    // buffer's data must be obtained before reading texture's pixels, since
+    // the data can be backed by client's shared memory.
+    struct wlr_buffer* buffer = NULL;
+    if(client_buffer != NULL) {
+        // Obtain the buffer the texture has been created from.
+        if((buffer = client_buffer->source) == NULL) {
+            return false;
+        }
+
+        // Begin access to buffer's data.
+        void* data = NULL;
+        uint32_t format = 0;
+        size_t stride = 0;
+
+        if(!wlr_buffer_begin_data_ptr_access(
+               buffer, WLR_BUFFER_DATA_PTR_ACCESS_READ, &data, &format,
+               &stride)) {
+            return false;
+        }
+
+        // If buffer's data has moved, then texture's image is out of date, and
+        // the rendering pass must be used, since it updates the image.
+        if(data != pixman_image_get_data(image)) {
+            return wlr_buffer_end_data_ptr_access(buffer), false;
+        }
+    }
+
+    // Compose the texture.
+    pixman_box32_t box = {
+        .x1 = rectangle.x,
+        .y1 = rectangle.y,
+        .x2 = rectangle.x + rectangle.width,
+        .y2 = rectangle.y + rectangle.height};
+
+    rose_pixman_compose(
+        context->image, context->clip_region, image, (int)(source.x),
+        (int)(source.y), box, is_texture_opaque);
+
+    // End access to buffer's data, if needed.
+    if(buffer != NULL) {
+        wlr_buffer_end_data_ptr_access(buffer);
+    }
+
+    // Operation succeeded.
+    return true;
+}
+
 static void
 rose_render_rectangle_with_texture(
     struct rose_rendering_context* context, struct wlr_texture* texture,
-    struct wlr_fbox* region, struct rose_rectangle rectangle) {
+    struct wlr_client_buffer* client_buffer, struct wlr_fbox* region,
+    struct rose_rectangle rectangle) {
     // Do nothing if there is no texture.
     if(texture == NULL) {
         return;
@@ -241,7 +623,13 @@ rose_render_rectangle_with_texture(
             rectangle, rose_output_state_obtain(context->output));
     }
 
-    // Render the rectangle.
+    // Compose the texture directly, if possible.
+    if(rose_render_rectangle_with_texture_directly(
+           context, texture, client_buffer, region, rectangle, false)) {
+        return;
+    }
+
+    // Otherwise, render the rectangle.
     struct wlr_render_texture_options options = {
         .texture = texture,
         .src_box = ((region != NULL) ? *region : (struct wlr_fbox){}),
@@ -250,12 +638,93 @@ rose_render_rectangle_with_texture(
              .y = rectangle.y,
              .width = rectangle.width,
              .height = rectangle.height},
-        .clip = &(context->scissor_rectangle),
+        .clip = context->clip_region,
         .transform = rectangle.transform};
 
     wlr_render_pass_add_texture(context->pass, &options);
 }
 
+static void
+rose_render_glyph_atlas_text(
+    struct rose_rendering_context* context, struct rose_glyph_atlas* atlas,
+    struct rose_glyph_atlas_text const* text, int width, int height,
+    struct rose_rectangle rectangle) {
+    // Note: The given rectangle represents the region of the text which starts
+    // at its origin and has the given size. Quads are clipped to this region.
+
+    // Obtain atlas' texture.
+    struct wlr_texture* texture = rose_glyph_atlas_obtain_texture(atlas);
+
+    // Do nothing if there is nothing to render.
+    if((texture == NULL) || (width <= 0) || (height <= 0)) {
+        return;
+    }
+
+    // Transform the rectangle.
+    if(!(rectangle.is_transformed)) {
+        rectangle = rose_rectangle_transform(
+            rectangle, rose_output_state_obtain(context->output));
+    }
+
+    // Compute scaling factors which map transformed text's region to the
+    // rectangle.
+    bool is_rotated = ((rectangle.transform % 2) != 0);
+
+    double sx = (double)(rectangle.width) / (is_rotated ? height : width);
+    double sy = (double)(rectangle.height) / (is_rotated ? width : height);
+
+    // Render the quads.
+    struct wlr_box bounds = {.width = width, .height = height};
+    for(int i = 0; i != text->line_count; ++i) {
+        struct rose_glyph_atlas_text_line const* line = &(text->lines[i]);
+
+        for(size_t j = 0; j != line->size; ++j) {
+            // Obtain current quad.
+            struct rose_glyph_atlas_quad const* quad = &(line->quads[j]);
+
+            // Clip quad's target to text's region.
+            struct wlr_box target = {};
+            if(!wlr_box_intersection(&target, &(quad->target), &bounds)) {
+                continue;
+            }
+
+            // Compute quad's source region.
+            struct wlr_fbox source = {
+                .x = quad->source.x + (target.x - quad->target.x),
+                .y = quad->source.y + (target.y - quad->target.y),
+                .width = target.width,
+                .height = target.height};
+
+            // Transform quad's target in the same way as texture's content.
+            wlr_box_transform(
+                &target, &target,
+                wlr_output_transform_invert(rectangle.transform), width,
+                height);
+
+#define scale_(x, s) (int)((double)(x) * (s) + 0.5)
+
+            // Compute resulting rectangle.
+            struct rose_rectangle result = {
+                .x = rectangle.x + scale_(target.x, sx),
+                .y = rectangle.y + scale_(target.y, sy),
+                .transform = rectangle.transform,
+                .is_transformed = true};
+
+            result.width =
+                rectangle.x + scale_(target.x + target.width, sx) - result.x;
+
+            result.height =
+                rectangle.y + scale_(target.y + target.height, sy) - result.y;
+
+#undef scale_
+
+            // Render the quad.
+            rose_render_rectangle_with_texture(
+                context, texture, NULL, &source, result);
+        }
+    }
+}
+
 static void
 rose_render_surface(struct wlr_surface* surface, int x, int y, void* data) {
     // Obtain surface rendering context.
@@ -273,9 +742,61 @@ rose_render_surface(struct wlr_surface* surface, int x, int y, void* data) {
     struct wlr_fbox region = {};
     wlr_surface_get_buffer_source_box(surface, &region);
 
+    // Obtain surface's buffer and texture.
+    struct wlr_client_buffer* buffer = surface->buffer;
+    struct wlr_texture* texture = wlr_surface_get_texture(surface);
+
+    // If content is composed directly, then compose surface's opaque region
+    // separately, since it can replace target's pixels instead of being
+    // blended over them.
+    // Note: Surface-local coordinates of the opaque region match output
+    // buffer's coordinates only if the output is neither transformed nor
+    // scaled.
+    struct rose_output_state output_state =
+        rose_output_state_obtain(context->parent->output);
+
+    pixman_region32_t* clip_region = context->parent->clip_region;
+    pixman_region32_t* blended_clip_region = clip_region;
+
+    pixman_region32_t blended_region;
+    pixman_region32_init(&blended_region);
+
+    if((context->parent->image != NULL) && (texture != NULL) &&
+       (output_state.transform == WL_OUTPUT_TRANSFORM_NORMAL) &&
+       (output_state.scale == 1.0) &&
+       pixman_region32_not_empty(&(surface->opaque_region))) {
+        // Compute the visible part of surface's opaque region.
+        pixman_region32_t opaque_region;
+        pixman_region32_init(&opaque_region);
+
+        pixman_region32_copy(&opaque_region, &(surface->opaque_region));
+        pixman_region32_translate(&opaque_region, rectangle.x, rectangle.y);
+        pixman_region32_intersect(&opaque_region, &opaque_region, clip_region);
+
+        // Compose it. The rectangle does not need to be transformed, since
+        // the output is neither transformed nor scaled.
+        context->parent->clip_region = &opaque_region;
+        if(rose_render_rectangle_with_texture_directly(
+               context->parent, texture, buffer, &region, rectangle, true)) {
+            // The rest of the surface is composed with blending.
+            pixman_region32_subtract(
+                &blended_region, clip_region, &opaque_region);
+
+            blended_clip_region = &blended_region;
+        }
+
+        // Clean-up the opaque region.
+        pixman_region32_fini(&opaque_region);
+    }
+
     // Render the rectangle with surface's texture.
+    context->parent->clip_region = blended_clip_region;
     rose_render_rectangle_with_texture(
-        context->parent, wlr_surface_get_texture(surface), &region, rectangle);
+        context->parent, texture, buffer, &region, rectangle);
+
+    // Restore the clipping region.
+    context->parent->clip_region = clip_region;
+    pixman_region32_fini(&blended_region);
 
     // Send presentation feedback.
     wlr_presentation_surface_textured_on_output(
@@ -287,6 +808,13 @@ rose_render_surface_decoration(
     struct rose_rendering_context* context,
     struct rose_color_scheme const* color_scheme,
     struct rose_rectangle surface_rectangle) {
+    // Note: The decoration consists of a 1-pixel frame and a 4-pixel border.
+    // The frame is rendered as four strips, and the border is rendered as a
+    // single rectangle which also fills the interior of the surface. This way
+    // no pixel is rendered twice, and the interior is rendered only where the
+    // clipping region permits, i.e., where it is not covered by surface's
+    // opaque region.
+
     // Update surface's rectangle.
     surface_rectangle.x -= 5;
     surface_rectangle.y -= 5;
@@ -294,18 +822,47 @@ rose_render_surface_decoration(
     surface_rectangle.width += 10;
     surface_rectangle.height += 10;
 
-    // Render surface's background frame.
-    rose_render_rectangle(
-        context, color_scheme->surface_background1, surface_rectangle);
+    // Render surface's frame.
+    struct rose_rectangle frame_strips[] = {
+        {.x = surface_rectangle.x,
+         .y = surface_rectangle.y,
+         .width = surface_rectangle.width,
+         .height = 1},
+        {.x = surface_rectangle.x,
+         .y = surface_rectangle.y + surface_rectangle.height - 1,
+         .width = surface_rectangle.width,
+         .height = 1},
+        {.x = surface_rectangle.x,
+         .y = surface_rectangle.y + 1,
+         .width = 1,
+         .height = surface_rectangle.height - 2},
+        {.x = surface_rectangle.x + surface_rectangle.width - 1,
+         .y = surface_rectangle.y + 1,
+         .width = 1,
+         .height = surface_rectangle.height - 2}};
+
+#define array_size_(a) ((size_t)(sizeof(a) / sizeof(a[0])))
+
+    for(size_t i = 0; i < array_size_(frame_strips); ++i) {
+        if((frame_strips[i].width > 0) && (frame_strips[i].height > 0)) {
+            rose_render_rectangle(
+                context, color_scheme->surface_background1, frame_strips[i]);
+        }
+    }
+
+#undef array_size_
 
+    // Render surface's border and interior.
     surface_rectangle.x += 1;
     surface_rectangle.y += 1;
 
     surface_rectangle.width -= 2;
     surface_rectangle.height -= 2;
 
-    rose_render_rectangle(
-        context, color_scheme->surface_background0, surface_rectangle);
+    if((surface_rectangle.width > 0) && (surface_rectangle.height > 0)) {
+        rose_render_rectangle(
+            context, color_scheme->surface_background0, surface_rectangle);
+    }
 }
 
 static void
@@ -347,11 +904,283 @@ rose_render_widgets(
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Direct scan-out context definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_scan_out_context {
+    // Surface which is displayed on the primary plane.
+    struct wlr_surface* surface;
+
+    // Its subsurfaces which are displayed on output's layers, along with the
+    // corresponding layer candidates, from bottom to top.
+    struct wlr_surface* subsurfaces[rose_output_layer_count_max];
+    struct rose_output_layer_candidate candidates[rose_output_layer_count_max];
+    size_t subsurface_count;
+
+    // Context's status.
+    enum rose_output_scan_out_status status;
+
+    // A flag which shows that the surface has been visited while iterating
+    // over its subsurfaces.
+    bool is_surface_visited;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Direct scan-out-related utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_scan_out_context_add_surface(
+    struct wlr_surface* surface, int x, int y, void* data) {
+    // Obtain the context.
+    struct rose_scan_out_context* context = data;
+
+    // Do nothing if scan-out is already known to be impossible.
+    if(context->status != rose_output_scan_out_status_success) {
+        return;
+    }
+
+    // The surface itself is displayed on the primary plane.
+    if(surface == context->surface) {
+        context->is_surface_visited = true;
+        return;
+    }
+
+    // Subsurfaces which are stacked below their parent can not be displayed on
+    // output's layers, since the layers are above the primary plane.
+    if(!(context->is_surface_visited) ||
+       (context->subsurface_count == rose_output_layer_count_max)) {
+        context->status = rose_output_scan_out_status_subsurfaces;
+        return;
+    }
+
+    // Skip subsurfaces which have no buffers.
+    if(surface->buffer == NULL) {
+        return;
+    }
+
+    // Subsurface's buffer must not be transformed, and must have the same
+    // scale as its parent's buffer.
+    if(surface->current.transform != WL_OUTPUT_TRANSFORM_NORMAL) {
+        context->status = rose_output_scan_out_status_transform_mismatch;
+        return;
+    }
+
+    if(surface->current.scale != context->surface->current.scale) {
+        context->status = rose_output_scan_out_status_scale_mismatch;
+        return;
+    }
+
+    // Add the subsurface.
+    // Note: The scale of the surface's buffer matches output's scale.
+    int scale = surface->current.scale;
+
+    struct rose_output_layer_candidate candidate = {
+        .buffer = &(surface->buffer->base),
+        .dst_box = {
+            .x = x * scale,
+            .y = y * scale,
+            .width = surface->current.width * scale,
+            .height = surface->current.height * scale}};
+
+    wlr_surface_get_buffer_source_box(surface, &(candidate.src_box));
+
+    context->subsurfaces[context->subsurface_count] = surface;
+    context->candidates[context->subsurface_count++] = candidate;
+}
+
+static enum rose_output_scan_out_status
+rose_scan_out_check(
+    struct rose_output* output, struct rose_workspace* workspace,
+    struct rose_ui_panel const* panel, struct rose_scan_out_context* context) {
+    // Scan-out is not possible during drag and drop operation.
+    if(output->cursor.drag_and_drop_surface != NULL) {
+        return rose_output_scan_out_status_drag_and_drop;
+    }
+
+    // Obtain workspace's focused surface.
+    struct rose_surface* focused_surface = workspace->focused_surface;
+
+    // If the workspace has no focused surface, or if any of the UI components
+    // are visible, or the workspace is not in normal mode, then scan-out is not
+    // possible.
+    if(focused_surface == NULL) {
+        return rose_output_scan_out_status_no_focused_surface;
+    }
+
+    if(panel->is_visible) {
+        return rose_output_scan_out_status_panel_visible;
+    }
+
+    if(output->ui.menu.is_visible) {
+        return rose_output_scan_out_status_menu_visible;
+    }
+
+    if(workspace->mode != rose_workspace_mode_normal) {
+        return rose_output_scan_out_status_workspace_mode;
+    }
+
+    // Obtain focused surface's state and its underlying implementation.
+    struct rose_surface_state focused_surface_state =
+        rose_surface_state_obtain(focused_surface);
+
+    struct wlr_surface* underlying = focused_surface->xdg_surface->surface;
+
+    // If the surface has no buffer, or it is not positioned properly, or it has
+    // popups, then scan-out is not possible.
+    if((underlying == NULL) || (underlying->buffer == NULL)) {
+        return rose_output_scan_out_status_no_buffer;
+    }
+
+    if((focused_surface_state.x != 0) || (focused_surface_state.y != 0)) {
+        return rose_output_scan_out_status_position;
+    }
+
+    if(!wl_list_empty(&(focused_surface->temporaries))) {
+        return rose_output_scan_out_status_popups;
+    }
+
+    // If focused surface's state does not match output's state, then scan-out
+    // is not possible.
+    struct rose_output_state output_state = rose_output_state_obtain(output);
+
+    if(underlying->current.transform != output_state.transform) {
+        return rose_output_scan_out_status_transform_mismatch;
+    }
+
+    if(underlying->current.scale != output_state.scale) {
+        return rose_output_scan_out_status_scale_mismatch;
+    }
+
+    // Collect surface's subsurfaces which shall be displayed on output's
+    // layers.
+    *context = (struct rose_scan_out_context){.surface = underlying};
+    wlr_surface_for_each_surface(
+        underlying, rose_scan_out_context_add_surface, context);
+
+    if(context->status != rose_output_scan_out_status_success) {
+        return context->status;
+    }
+
+    // Layers can only be used if output's buffer is not transformed.
+    if((context->subsurface_count != 0) &&
+       (output_state.transform != WL_OUTPUT_TRANSFORM_NORMAL)) {
+        return rose_output_scan_out_status_transform_mismatch;
+    }
+
+    // If any of the normal UI widgets is visible, then scan-out is not
+    // possible.
+    struct rose_surface* surface = NULL;
+    for(ptrdiff_t i = rose_surface_special_widget_type_count_;
+        i != rose_surface_widget_type_count_; ++i) {
+        wl_list_for_each(
+            surface, &(output->ui.surfaces_mapped[i]), link_mapped) {
+            if(rose_output_ui_is_surface_visible(&(output->ui), surface)) {
+                return rose_output_scan_out_status_widget_visible;
+            }
+        }
+    }
+
+    // Scan-out is possible.
+    return rose_output_scan_out_status_success;
+}
+
+static enum rose_output_scan_out_status
+rose_scan_out(
+    struct rose_output* output, struct rose_scan_out_context const* context) {
+    // Obtain the surface which shall be displayed on the primary plane.
+    struct wlr_surface* underlying = context->surface;
+
+    // Initialize an empty state.
+    struct wlr_output_state state = {};
+    wlr_output_state_init(&state);
+
+    // Configure primary swapchain.
+    if(!wlr_output_configure_primary_swapchain(
+           output->device, &state, &(output->device->swapchain))) {
+        return wlr_output_state_finish(&state),
+               rose_output_scan_out_status_swapchain_failure;
+    }
+
+    // Count the attempt.
+    rose_metrics_counter_add(
+        &(output->context->metrics),
+        rose_metrics_counter_type_scan_out_attempts, 1);
+
+    // Attach focused surface's buffer along with the damage of the current
+    // frame.
+    // Note: The damage is not consumed until the commit succeeds, since
+    // otherwise the content is composed, and the damage is committed along
+    // with the rendered buffer.
+    wlr_output_state_set_buffer(&state, &(underlying->buffer->base));
+    if(true) {
+        pixman_region32_t frame_damage;
+        pixman_region32_init(&frame_damage);
+
+        rose_output_obtain_frame_damage(output, &frame_damage);
+        wlr_output_state_set_damage(&state, &frame_damage);
+
+        pixman_region32_fini(&frame_damage);
+    }
+
+    // Try committing the state with surface's subsurfaces placed on output's
+    // layers.
+    struct wlr_output_layer_state layer_states[rose_output_layer_count_max];
+
+    switch(rose_output_layer_set_try(
+        &(output->layers), output->device, &state, context->candidates,
+        context->subsurface_count, layer_states)) {
+        case rose_output_layer_set_commit_status_success:
+            break;
+
+        case rose_output_layer_set_commit_status_layer_rejection:
+            return wlr_output_state_finish(&state),
+                   rose_output_scan_out_status_layer_rejection;
+
+        case rose_output_layer_set_commit_status_test_failure:
+            return wlr_output_state_finish(&state),
+                   rose_output_scan_out_status_test_failure;
+
+        case rose_output_layer_set_commit_status_commit_failure:
+            return wlr_output_state_finish(&state),
+                   rose_output_scan_out_status_commit_failure;
+    }
+
+    // Consume the damage of the current frame.
+    rose_output_clear_frame_damage(output);
+
+    // Send presentation feedback.
+    wlr_presentation_surface_scanned_out_on_output(underlying, output->device);
+    for(size_t i = 0; i != context->subsurface_count; ++i) {
+        wlr_presentation_surface_scanned_out_on_output(
+            context->subsurfaces[i], output->device);
+    }
+
+    // Mark the output as scanned-out, and count the success.
+    output->is_scanned_out = true;
+
+    rose_metrics_counter_add(
+        &(output->context->metrics),
+        rose_metrics_counter_type_scan_out_successes, 1);
+
+    // Scan-out succeeded.
+    return wlr_output_state_finish(&state),
+           rose_output_scan_out_status_success;
+}
+
+static void
+rose_scan_out_status_save(
+    struct rose_output* output, enum rose_output_scan_out_status status) {
+    output->scan_out_status = status;
+    output->scan_out_status_counts[status]++;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Content rendering interface implementation.
 ////////////////////////////////////////////////////////////////////////////////
 
-void
+struct rose_rendering_result
 rose_render_content(struct rose_output* output) {
     // Obtain output's focused workspace.
     struct rose_workspace* workspace = output->focused_workspace;
@@ -366,13 +1195,19 @@ rose_render_content(struct rose_output* output) {
     // If the screen is locked, or the given output has no focused workspace,
     // then render output's visible widgets, and do nothing else.
     if((output->context->is_screen_locked) || (workspace == NULL)) {
+        // Save scan-out status.
+        rose_scan_out_status_save(
+            output, ((output->context->is_screen_locked)
+                         ? rose_output_scan_out_status_screen_locked
+                         : rose_output_scan_out_status_no_workspace));
+
         // Initialize rendering context.
         struct rose_rendering_context context = {};
         if(!rose_rendering_context_initialize(&context, output)) {
-            return;
+            return (struct rose_rendering_result){};
         }
 
-        if(!pixman_region32_not_empty(&(context.scissor_rectangle))) {
+        if(!pixman_region32_not_empty(&(context.scissor_region))) {
             return rose_rendering_context_finalize(&context);
         }
 
@@ -408,133 +1243,87 @@ rose_render_content(struct rose_output* output) {
     struct rose_ui_menu* menu = &(output->ui.menu);
 
     // Try using direct scan-out.
-    while(output->cursor.drag_and_drop_surface == NULL) {
-        // Obtain workspace's focused surface.
-        struct rose_surface* focused_surface = workspace->focused_surface;
-
-        // If the workspace has no focused surface, or if any of the UI
-        // components are visible, or the workspace is not in normal mode, then
-        // direct scan-out is not possible.
-        if((focused_surface == NULL) ||
-           (panel.is_visible || menu->is_visible) ||
-           (workspace->mode != rose_workspace_mode_normal)) {
-            break;
-        }
-
-        // Obtain focused surface's state.
-        struct rose_surface_state focused_surface_state =
-            rose_surface_state_obtain(focused_surface);
-
-        // Obtain focused surface's underlying implementation.
-        struct wlr_surface* underlying = focused_surface->xdg_surface->surface;
-
-        // If the surface is not positioned properly, or it has child entities,
-        // then scan-out is not possible.
-        if((focused_surface_state.x != 0) || //
-           (focused_surface_state.y != 0) || //
-           (underlying == NULL) ||
-           !wl_list_empty(&(focused_surface->subsurfaces)) ||
-           !wl_list_empty(&(focused_surface->temporaries))) {
-            break;
-        }
-
-        // If focused surface's state does not match output's state, then
-        // scan-out is not possible.
-        if((underlying->current.transform != output_state.transform) ||
-           (underlying->current.scale != output_state.scale)) {
-            break;
-        }
-
-        // If any of the normal UI widgets is visible, then scan-out is not
-        // possible.
-        if(true) {
-            // At this point there are no visible widgets.
-            bool is_found = false;
-
-            // Search for a visible widget surface.
-            struct rose_surface* surface = NULL;
-            for(ptrdiff_t i = rose_surface_special_widget_type_count_;
-                i != rose_surface_widget_type_count_; ++i) {
-                wl_list_for_each(
-                    surface, &(output->ui.surfaces_mapped[i]), link_mapped) {
-                    if(rose_output_ui_is_surface_visible(
-                           &(output->ui), surface)) {
-                        goto found;
-                    }
-                }
-
-                continue;
+    struct rose_scan_out_context scan_out_context = {};
+    enum rose_output_scan_out_status scan_out_status =
+        rose_scan_out_check(output, workspace, &panel, &scan_out_context);
 
-            found:
-                is_found = true;
-                break;
-            }
+    if(scan_out_status == rose_output_scan_out_status_success) {
+        scan_out_status = rose_scan_out(output, &scan_out_context);
+    }
 
-            // If such widget has been found, then scan-out is not possible.
-            if(is_found) {
-                break;
-            }
-        }
+    // Save scan-out status.
+    rose_scan_out_status_save(output, scan_out_status);
 
-        // Initialize an empty state.
-        struct wlr_output_state state = {};
-        wlr_output_state_init(&state);
+    // Do nothing else if scan-out succeeded, or if output's swapchain could not
+    // be configured.
+    // Note: Only the focused surface can be seen in direct scan-out mode.
+    switch(scan_out_status) {
+        case rose_output_scan_out_status_success:
+            rose_reset_surface_occlusion(workspace, workspace->focused_surface);
+            return (struct rose_rendering_result){
+                .type = rose_rendering_result_type_scanned_out};
 
-        // Configure primary swapchain.
-        if(!wlr_output_configure_primary_swapchain(
-               output->device, &state, &(output->device->swapchain))) {
-            return wlr_output_state_finish(&state);
-        }
+        case rose_output_scan_out_status_swapchain_failure:
+            rose_reset_surface_occlusion(workspace, NULL);
+            return (struct rose_rendering_result){};
 
-        // Try attaching focused surface's buffer.
-        wlr_output_state_set_buffer(&state, &(underlying->buffer->base));
-        if(!wlr_output_test_state(output->device, &state)) {
-            wlr_output_state_finish(&state);
-            break;
-        }
-
-        // Try committing the rendering operation.
-        if(!wlr_output_commit_state(output->device, &state)) {
-            wlr_output_state_finish(&state);
+        default:
             break;
-        }
-
-        // Send presentation feedback.
-        wlr_presentation_surface_scanned_out_on_output(
-            underlying, output->device);
-
-        // Mark the output as scanned-out.
-        output->is_scanned_out = true;
-
-        // Do nothing else.
-        return wlr_output_state_finish(&state);
     }
 
     // Initialize rendering context.
     struct rose_rendering_context context = {};
     if(!rose_rendering_context_initialize(&context, output)) {
-        return;
+        rose_reset_surface_occlusion(workspace, NULL);
+        return (struct rose_rendering_result){};
     }
 
-    if(!pixman_region32_not_empty(&(context.scissor_rectangle))) {
+    if(!pixman_region32_not_empty(&(context.scissor_region))) {
         return rose_rendering_context_finalize(&context);
     }
 
-    // Fill-in with solid color.
-    if(true) {
-        struct rose_rectangle rectangle = {
-            .width = output->device->width,
-            .height = output->device->height,
-            .is_transformed = true};
+    // Compute visible regions of workspace's surfaces and of the background.
+    // Note: Snapshots of running transactions are not subject to occlusion
+    // culling.
+    struct rose_surface_visibility visibility[rose_occlusion_surface_count_max];
+    ptrdiff_t visibility_count = 0;
 
-        rose_render_rectangle(
-            &context, color_scheme.workspace_background, rectangle);
+    pixman_region32_t background_region;
+    pixman_region32_init(&background_region);
+
+    if(workspace->transaction.sentinel > 0) {
+        pixman_region32_copy(&background_region, &(context.scissor_region));
+        rose_reset_surface_occlusion(workspace, NULL);
+    } else {
+        visibility_count = rose_compute_surface_visibility(
+            &context, workspace, &color_scheme, visibility,
+            &background_region);
     }
 
-    // Render background widget.
-    rose_render_widgets(
-        &context, rose_surface_widget_type_background,
-        rose_surface_widget_type_background + 1);
+    // Render the background.
+    if(pixman_region32_not_empty(&background_region)) {
+        // Limit rendering to background's visible region.
+        context.clip_region = &background_region;
+
+        // Fill-in with solid color.
+        if(true) {
+            struct rose_rectangle rectangle = {
+                .width = output->device->width,
+                .height = output->device->height,
+                .is_transformed = true};
+
+            rose_render_rectangle(
+                &context, color_scheme.workspace_background, rectangle);
+        }
+
+        // Render background widget.
+        rose_render_widgets(
+            &context, rose_surface_widget_type_background,
+            rose_surface_widget_type_background + 1);
+
+        // Restore the clipping region.
+        context.clip_region = &(context.scissor_region);
+    }
 
     // Render the workspace.
     if(workspace->transaction.sentinel > 0) {
@@ -555,10 +1344,11 @@ rose_render_content(struct rose_output* output) {
             if((surface_snapshot->type == rose_surface_snapshot_type_normal) &&
                (surface_snapshot->buffer != NULL)) {
                 // If the snapshot represents a surface, then obtain its
-                // texture.
-                struct wlr_texture* texture =
-                    ((struct wlr_client_buffer*)(surface_snapshot->buffer))
-                        ->texture;
+                // buffer and texture.
+                struct wlr_client_buffer* buffer =
+                    (struct wlr_client_buffer*)(surface_snapshot->buffer);
+
+                struct wlr_texture* texture = buffer->texture;
 
                 // Obtain the visible region of the surface's buffer.
                 struct wlr_fbox region = {
@@ -569,7 +1359,7 @@ rose_render_content(struct rose_output* output) {
 
                 // And render it.
                 rose_render_rectangle_with_texture(
-                    &context, texture, &region, rectangle);
+                    &context, texture, buffer, &region, rectangle);
             } else if(
                 surface_snapshot->type ==
                 rose_surface_snapshot_type_decoration) {
@@ -582,10 +1372,32 @@ rose_render_content(struct rose_output* output) {
         // Update panel's data from transaction's snapshot.
         panel = workspace->transaction.snapshot.panel;
     } else {
-        // Otherwise, render all visible surfaces.
+        // Otherwise, render all visible surfaces. Compute the index of the
+        // bottommost surface in the visibility array.
+        ptrdiff_t i = wl_list_length(&(workspace->surfaces_visible)) - 1;
+
         struct rose_surface* surface = NULL;
         wl_list_for_each(
             surface, &(workspace->surfaces_visible), link_visible) {
+            // Obtain surface's visible regions. Surfaces which are not subject
+            // to occlusion culling are clipped to the scissor region.
+            pixman_region32_t* surface_region = &(context.scissor_region);
+            pixman_region32_t* decoration_region = &(context.scissor_region);
+
+            if(i < visibility_count) {
+                surface_region = &(visibility[i].surface);
+                decoration_region = &(visibility[i].decoration);
+            }
+
+            // Advance the index.
+            --i;
+
+            // Skip the surface if it and its decoration are fully occluded.
+            if(!pixman_region32_not_empty(surface_region) &&
+               !pixman_region32_not_empty(decoration_region)) {
+                continue;
+            }
+
             // Obtain surface's state.
             struct rose_surface_state surface_state =
                 rose_surface_state_obtain(surface);
@@ -597,27 +1409,38 @@ rose_render_content(struct rose_output* output) {
                 .dy = surface_state.y};
 
             // Render surface's decoration, if needed.
-            if(!(surface_state.is_maximized || surface_state.is_fullscreen) &&
-               ((surface->xdg_decoration == NULL) ||
-                (surface->xdg_decoration->current.mode ==
-                 WLR_XDG_TOPLEVEL_DECORATION_V1_MODE_SERVER_SIDE))) {
+            if(rose_surface_is_decorated(surface, surface_state) &&
+               pixman_region32_not_empty(decoration_region)) {
                 struct rose_rectangle rectangle = {
                     .x = surface_rendering_context.dx,
                     .y = surface_rendering_context.dy,
                     .width = surface_state.width,
                     .height = surface_state.height};
 
+                context.clip_region = decoration_region;
                 rose_render_surface_decoration(
                     &context, &color_scheme, rectangle);
             }
 
             // Render the surface.
+            context.clip_region = surface_region;
             wlr_xdg_surface_for_each_surface(
                 surface->xdg_surface, rose_render_surface,
                 &surface_rendering_context);
         }
+
+        // Restore the clipping region.
+        context.clip_region = &(context.scissor_region);
+    }
+
+    // Free memory occupied by visibility data.
+    for(ptrdiff_t i = 0; i != visibility_count; ++i) {
+        pixman_region32_fini(&(visibility[i].surface));
+        pixman_region32_fini(&(visibility[i].decoration));
     }
 
+    pixman_region32_fini(&background_region);
+
     // Render the panel, if needed.
     if(panel.is_visible) {
         // Initialize panel's rectangle.
@@ -653,20 +1476,27 @@ rose_render_content(struct rose_output* output) {
         // Start rendering panel's text.
         int dx = 1;
 
-        // Obtain title bar's raster.
+        // Obtain title bar's glyphs and raster. If the glyphs are valid, then
+        // they are rendered instead of the raster.
+        struct rose_glyph_atlas_text* glyphs = output->glyphs.title;
         struct rose_raster* raster = output->rasters.title;
 
+        if((glyphs != NULL) && !(glyphs->is_valid)) {
+            glyphs = NULL;
+        }
+
         // Render the title bar.
-        if(raster != NULL) {
+        if((glyphs != NULL) || (raster != NULL)) {
             bool is_tilted = (panel.position == rose_ui_panel_position_left) ||
                              (panel.position == rose_ui_panel_position_right);
 
-            // Compute the extent.
-            rectangle.width =
-                (is_tilted ? raster->base.height : raster->base.width);
+            // Obtain title's size.
+            int width = ((glyphs != NULL) ? glyphs->width : raster->width);
+            int height = ((glyphs != NULL) ? glyphs->height : raster->height);
 
-            rectangle.height =
-                (is_tilted ? raster->base.width : raster->base.height);
+            // Compute the extent.
+            rectangle.width = (is_tilted ? height : width);
+            rectangle.height = (is_tilted ? width : height);
 
 #define scale_(x) (int)((double)(x) / output_state.scale + 0.5)
 
@@ -687,9 +1517,19 @@ rose_render_content(struct rose_output* output) {
                 rectangle.x += dx;
             }
 
-            // Render the texture.
-            rose_render_rectangle_with_texture(
-                &context, raster->texture, NULL, rectangle);
+            // Render the title.
+            if(glyphs != NULL) {
+                rose_render_glyph_atlas_text(
+                    &context, output->glyphs.atlas, glyphs, width, height,
+                    rectangle);
+            } else {
+                // Note: Raster's texture can be larger than the title, since
+                // rasters are obtained from the pool.
+                struct wlr_fbox box = {.width = width, .height = height};
+
+                rose_render_rectangle_with_texture(
+                    &context, raster->texture, NULL, &box, rectangle);
+            }
         }
     }
 
@@ -734,11 +1574,17 @@ rose_render_content(struct rose_output* output) {
             }
         }
 
-        // Obtain menu text's raster.
+        // Obtain menu text's glyphs and raster. If the glyphs are valid, then
+        // they are rendered instead of the raster.
+        struct rose_glyph_atlas_text* glyphs = output->glyphs.menu;
         struct rose_raster* raster = output->rasters.menu;
 
+        if((glyphs != NULL) && !(glyphs->is_valid)) {
+            glyphs = NULL;
+        }
+
         // Render the text.
-        if(raster != NULL) {
+        if((glyphs != NULL) || (raster != NULL)) {
             // Adjust the rectangle.
             rectangle.x = menu->area.x + menu->layout.margin_x;
             rectangle.y = menu->area.y + menu->layout.margin_y;
@@ -749,9 +1595,24 @@ rose_render_content(struct rose_output* output) {
                 .width = rectangle.width * output_state.scale,
                 .height = rectangle.height * output_state.scale};
 
-            // Render the texture.
-            rose_render_rectangle_with_texture(
-                &context, raster->texture, &box, rectangle);
+            // Render the text.
+            if(glyphs != NULL) {
+                rose_render_glyph_atlas_text(
+                    &context, output->glyphs.atlas, glyphs, (int)(box.width),
+                    (int)(box.height), rectangle);
+            } else {
+                // Note: Cropping box must not exceed raster's used region.
+                if(box.width > raster->width) {
+                    box.width = raster->width;
+                }
+
+                if(box.height > raster->height) {
+                    box.height = raster->height;
+                }
+
+                rose_render_rectangle_with_texture(
+                    &context, raster->texture, NULL, &box, rectangle);
+            }
         }
     }
 
@@ -927,35 +1788,49 @@ rose_render_content(struct rose_output* output) {
 #ifdef ROSE_RENDER_DAMAGE
     // Render the damage.
     if(true) {
-        // Construct rectangles which represent damaged region.
-        struct rose_rectangle rectangles[] = {
-            {.x = context.damage.x,
-             .y = context.damage.y,
-             .width = 2,
-             .height = context.damage.height,
-             .is_transformed = true},
-            {.x = context.damage.x,
-             .y = context.damage.y,
-             .width = context.damage.width,
-             .height = 2,
-             .is_transformed = true},
-            {.x = context.damage.x + context.damage.width - 2,
-             .y = context.damage.y,
-             .width = 2,
-             .height = context.damage.height,
-             .is_transformed = true},
-            {.x = context.damage.x,
-             .y = context.damage.y + context.damage.height - 2,
-             .width = context.damage.width,
-             .height = 2,
-             .is_transformed = true}};
+        // Obtain damaged region's rectangles.
+        int damage_rectangle_count = 0;
+        pixman_box32_t const* damage_rectangles = pixman_region32_rectangles(
+            &(context.scissor_region), &damage_rectangle_count);
 
         // Initialize damage's color.
         struct rose_color color_red = {.rgba32 = {0xFF, 0, 0, 0xFF}};
 
-        // Render the damage.
-        for(size_t i = 0; i < array_size_(rectangles); ++i) {
-            rose_render_rectangle(&context, color_red, rectangles[i]);
+        // Render each damaged rectangle's outline.
+        for(int i = 0; i != damage_rectangle_count; ++i) {
+            struct rose_output_damage damage = {
+                .x = damage_rectangles[i].x1,
+                .y = damage_rectangles[i].y1,
+                .width = damage_rectangles[i].x2 - damage_rectangles[i].x1,
+                .height = damage_rectangles[i].y2 - damage_rectangles[i].y1};
+
+            // Construct rectangles which represent damaged region.
+            struct rose_rectangle rectangles[] = {
+                {.x = damage.x,
+                 .y = damage.y,
+                 .width = 2,
+                 .height = damage.height,
+                 .is_transformed = true},
+                {.x = damage.x,
+                 .y = damage.y,
+                 .width = damage.width,
+                 .height = 2,
+                 .is_transformed = true},
+                {.x = damage.x + damage.width - 2,
+                 .y = damage.y,
+                 .width = 2,
+                 .height = damage.height,
+                 .is_transformed = true},
+                {.x = damage.x,
+                 .y = damage.y + damage.height - 2,
+                 .width = damage.width,
+                 .height = 2,
+                 .is_transformed = true}};
+
+            // Render the damage.
+            for(size_t j = 0; j < array_size_(rectangles); ++j) {
+                rose_render_rectangle(&context, color_red, rectangles[j]);
+            }
         }
     }
 #endif
@@ -7,6 +7,7 @@
 #define H_7C346532827B4C42BA078CA25929AE6C
 
 #include "rendering_text.h"
+#include <stdint.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Forward declarations.
@@ -14,12 +15,39 @@
 
 struct rose_output;
 
+////////////////////////////////////////////////////////////////////////////////
+// Rendering result definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_rendering_result_type {
+    // Nothing has been committed to the output.
+    rose_rendering_result_type_none,
+
+    // Output's content has been rendered and committed.
+    rose_rendering_result_type_rendered,
+
+    // Output has been put in direct scan-out mode.
+    rose_rendering_result_type_scanned_out
+};
+
+struct rose_rendering_result {
+    // Result's type.
+    enum rose_rendering_result_type type;
+
+    // Area of the damaged region which has been redrawn (in pixels).
+    uint64_t damage_area;
+
+    // A flag which shows that rendering operation has been measured by the
+    // timer of output's frame scheduler.
+    bool is_timed;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Content rendering interface.
 ////////////////////////////////////////////////////////////////////////////////
 
 // Renders the visible content (focused workspace) of the given output.
-void
+struct rose_rendering_result
 rose_render_content(struct rose_output* output);
 
 #endif // H_7C346532827B4C42BA078CA25929AE6C
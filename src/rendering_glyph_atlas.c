@@ -0,0 +1,360 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "rendering_glyph_atlas.h"
+#include "rendering_raster.h"
+#include "rendering_text_compositing.h"
+
+#include <pixman.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph atlas definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    // Atlas' width and height (in pixels).
+    rose_glyph_atlas_size = 1024,
+
+    // Transparent border around each glyph, prevents neighbouring glyphs from
+    // bleeding into each other when the texture is filtered.
+    rose_glyph_atlas_padding = 1,
+
+    // Hash table's parameters. Bucket count must be a power of two.
+    rose_glyph_atlas_entry_count_max = 2048,
+    rose_glyph_atlas_bucket_count = 4096,
+
+    // Maximum number of shelves.
+    rose_glyph_atlas_shelf_count_max = 256
+};
+
+struct rose_glyph_atlas_entry {
+    // Glyph's identifier and color (in ARGB8888 format).
+    uint64_t id;
+    uint32_t color;
+
+    // Glyph's region in the atlas (without padding).
+    struct wlr_box box;
+
+    // Flag: indicates that the entry is occupied.
+    bool is_used;
+};
+
+// Note: Glyphs are packed into horizontal shelves, each shelf holds glyphs of
+// similar height.
+struct rose_glyph_atlas_shelf {
+    int y, height, width_used;
+};
+
+struct rose_glyph_atlas {
+    // Atlas' pixels and texture.
+    struct rose_raster* raster;
+
+    // Glyph compositing kernel.
+    rose_compositing_kernel_fn composite;
+
+    // Hash table of glyphs (uses open addressing with linear probing).
+    struct rose_glyph_atlas_entry entries[rose_glyph_atlas_bucket_count];
+    int entry_count;
+
+    // Shelves.
+    struct rose_glyph_atlas_shelf shelves[rose_glyph_atlas_shelf_count_max];
+    int shelf_count;
+
+    // Region of the atlas which has not been uploaded to the texture yet.
+    pixman_region32_t dirty_region;
+
+    // Flag: indicates that the atlas has run out of space.
+    bool is_full;
+};
+
+_Static_assert(
+    (rose_glyph_atlas_bucket_count & (rose_glyph_atlas_bucket_count - 1)) == 0,
+    "bucket count must be a power of two");
+
+_Static_assert(
+    rose_glyph_atlas_entry_count_max < rose_glyph_atlas_bucket_count,
+    "hash table must always have empty buckets");
+
+////////////////////////////////////////////////////////////////////////////////
+// Hash table manipulation utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t
+rose_glyph_atlas_compute_hash(uint64_t id, uint32_t color) {
+    uint64_t hash = (id ^ ((uint64_t)(color) << 29)) * 0x9E3779B97F4A7C15u;
+    return (size_t)(hash >> 32) & (rose_glyph_atlas_bucket_count - 1);
+}
+
+static struct rose_glyph_atlas_entry*
+rose_glyph_atlas_find_entry(
+    struct rose_glyph_atlas* atlas, uint64_t id, uint32_t color) {
+    // Find either an entry with the given key, or an empty entry.
+    // Note: This cycle always terminates, since the table always has empty
+    // entries.
+    for(size_t i = rose_glyph_atlas_compute_hash(id, color);;
+        i = (i + 1) & (rose_glyph_atlas_bucket_count - 1)) {
+        struct rose_glyph_atlas_entry* entry = &(atlas->entries[i]);
+
+        if(!(entry->is_used) ||
+           ((entry->id == id) && (entry->color == color))) {
+            return entry;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Space allocation utility function.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool
+rose_glyph_atlas_allocate(
+    struct rose_glyph_atlas* atlas, int width, int height,
+    struct wlr_box* result) {
+    // Find the lowest shelf which can fit the given region.
+    struct rose_glyph_atlas_shelf* shelf = NULL;
+
+    for(int i = 0; i != atlas->shelf_count; ++i) {
+        struct rose_glyph_atlas_shelf* x = &(atlas->shelves[i]);
+
+        if((x->height >= height) &&
+           ((rose_glyph_atlas_size - x->width_used) >= width) &&
+           ((shelf == NULL) || (x->height < shelf->height))) {
+            shelf = x;
+        }
+    }
+
+    // If there is no such shelf, then add a new one.
+    if(shelf == NULL) {
+        if(atlas->shelf_count == rose_glyph_atlas_shelf_count_max) {
+            return false;
+        }
+
+        int y = 0;
+        if(atlas->shelf_count != 0) {
+            struct rose_glyph_atlas_shelf* last =
+                &(atlas->shelves[atlas->shelf_count - 1]);
+
+            y = last->y + last->height;
+        }
+
+        if(((rose_glyph_atlas_size - y) < height) ||
+           (rose_glyph_atlas_size < width)) {
+            return false;
+        }
+
+        shelf = &(atlas->shelves[atlas->shelf_count++]);
+        *shelf = (struct rose_glyph_atlas_shelf){.y = y, .height = height};
+    }
+
+    // Allocate the region.
+    *result = (struct wlr_box){
+        .x = shelf->width_used,
+        .y = shelf->y,
+        .width = width,
+        .height = height};
+
+    shelf->width_used += width;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization/destruction interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_glyph_atlas*
+rose_glyph_atlas_initialize(struct wlr_renderer* renderer) {
+    // Allocate and initialize a new atlas.
+    struct rose_glyph_atlas* atlas = malloc(sizeof(struct rose_glyph_atlas));
+    if(atlas == NULL) {
+        return atlas;
+    } else {
+        *atlas = (struct rose_glyph_atlas){
+            .composite = rose_compositing_kernel_select()};
+
+        pixman_region32_init(&(atlas->dirty_region));
+    }
+
+    // Initialize atlas' pixels and texture.
+    atlas->raster = rose_raster_initialize(
+        renderer, rose_glyph_atlas_size, rose_glyph_atlas_size);
+
+    if(atlas->raster == NULL) {
+        return (rose_glyph_atlas_destroy(atlas), NULL);
+    }
+
+    return atlas;
+}
+
+void
+rose_glyph_atlas_destroy(struct rose_glyph_atlas* atlas) {
+    if(atlas != NULL) {
+        rose_raster_destroy(atlas->raster);
+        pixman_region32_fini(&(atlas->dirty_region));
+
+        free(atlas);
+    }
+}
+
+struct rose_glyph_atlas_text*
+rose_glyph_atlas_text_initialize(int line_count) {
+    // Allocate and zero-initialize a new text.
+    size_t size =
+        sizeof(struct rose_glyph_atlas_text) +
+        sizeof(struct rose_glyph_atlas_text_line) * (size_t)(line_count);
+
+    struct rose_glyph_atlas_text* text = calloc(1, size);
+
+    if(text != NULL) {
+        text->line_count = line_count;
+    }
+
+    return text;
+}
+
+void
+rose_glyph_atlas_text_destroy(struct rose_glyph_atlas_text* text) {
+    free(text);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph manipulation interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+bool
+rose_glyph_atlas_add_glyphs(
+    struct rose_glyph_atlas* atlas,
+    struct rose_glyph_placement_list const* placements, struct rose_color color,
+    int dy, struct rose_glyph_atlas_text_line* line) {
+    // Initialize an empty line.
+    line->size = 0;
+
+    // Do nothing if the atlas is full.
+    if(atlas->is_full) {
+        return false;
+    }
+
+    // Obtain color in ARGB8888 format.
+    uint32_t argb = ((uint32_t)(color.rgba8[0]) << 16) |
+                    ((uint32_t)(color.rgba8[1]) << 8) |
+                    ((uint32_t)(color.rgba8[2]));
+
+    // Add the glyphs.
+    for(size_t i = 0; i != placements->size; ++i) {
+        // Obtain current glyph's placement.
+        struct rose_glyph_placement const* placement = &(placements->data[i]);
+
+        // Find glyph's entry.
+        struct rose_glyph_atlas_entry* entry =
+            rose_glyph_atlas_find_entry(atlas, placement->id, argb);
+
+        // Add the glyph to the atlas, if needed.
+        if(!(entry->is_used)) {
+            // Allocate a region for the glyph.
+            struct wlr_box box = {};
+            if((atlas->entry_count == rose_glyph_atlas_entry_count_max) ||
+               !rose_glyph_atlas_allocate(
+                   atlas,
+                   placement->bitmap_width + 2 * rose_glyph_atlas_padding,
+                   placement->bitmap_height + 2 * rose_glyph_atlas_padding,
+                   &box)) {
+                return (atlas->is_full = true), false;
+            }
+
+            // Clear the region.
+            for(int j = 0; j != box.height; ++j) {
+                memset(
+                    atlas->raster->pixels +
+                        4 * (rose_glyph_atlas_size * (box.y + j) + box.x),
+                    0, 4 * (size_t)(box.width));
+            }
+
+            // Mark the region as dirty.
+            pixman_region32_union_rect(
+                &(atlas->dirty_region), &(atlas->dirty_region), box.x, box.y,
+                (unsigned)(box.width), (unsigned)(box.height));
+
+            // Exclude the padding.
+            box.x += rose_glyph_atlas_padding;
+            box.y += rose_glyph_atlas_padding;
+            box.width -= 2 * rose_glyph_atlas_padding;
+            box.height -= 2 * rose_glyph_atlas_padding;
+
+            // Render the glyph.
+            for(int j = 0; j != box.height; ++j) {
+                atlas->composite(
+                    atlas->raster->pixels +
+                        4 * (rose_glyph_atlas_size * (box.y + j) + box.x),
+                    placement->bitmap + placement->bitmap_width * j,
+                    (size_t)(box.width), argb);
+            }
+
+            // Initialize the entry.
+            *entry = (struct rose_glyph_atlas_entry){
+                .id = placement->id,
+                .color = argb,
+                .box = box,
+                .is_used = true};
+
+            atlas->entry_count++;
+        }
+
+        // Compute glyph's quad.
+        line->quads[line->size++] = (struct rose_glyph_atlas_quad){
+            .source =
+                {.x = entry->box.x + placement->dx,
+                 .y = entry->box.y + placement->dy,
+                 .width = placement->width,
+                 .height = placement->height},
+            .target = {
+                .x = placement->x,
+                .y = placement->y + dy,
+                .width = placement->width,
+                .height = placement->height}};
+    }
+
+    return true;
+}
+
+void
+rose_glyph_atlas_flush(struct rose_glyph_atlas* atlas) {
+    if(pixman_region32_not_empty(&(atlas->dirty_region))) {
+        rose_raster_texture_update(atlas->raster, &(atlas->dirty_region));
+        pixman_region32_clear(&(atlas->dirty_region));
+    }
+}
+
+void
+rose_glyph_atlas_reset(struct rose_glyph_atlas* atlas) {
+    // Remove all entries.
+    for(ptrdiff_t i = 0; i != rose_glyph_atlas_bucket_count; ++i) {
+        atlas->entries[i].is_used = false;
+    }
+
+    atlas->entry_count = 0;
+
+    // Remove all shelves.
+    // Note: Pixels are not cleared, since regions of newly added glyphs are
+    // cleared before rendering.
+    atlas->shelf_count = 0;
+
+    // Clear the flag.
+    atlas->is_full = false;
+}
+
+bool
+rose_glyph_atlas_is_full(struct rose_glyph_atlas* atlas) {
+    return atlas->is_full;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Texture access interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+struct wlr_texture*
+rose_glyph_atlas_obtain_texture(struct rose_glyph_atlas* atlas) {
+    return atlas->raster->texture;
+}
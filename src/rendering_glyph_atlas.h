@@ -0,0 +1,108 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_5B0E4C8A27D34F1E9A6D3C71B8F2E940
+#define H_5B0E4C8A27D34F1E9A6D3C71B8F2E940
+
+#include "rendering_text.h"
+#include <wlr/util/box.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Forward declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+struct wlr_renderer;
+struct wlr_texture;
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph atlas declaration.
+// Note: Pointer to this type shall be used as an opaque handle.
+//
+// Note: Glyph atlas is a texture which holds colored glyphs. Text is rendered
+// from the atlas as a set of textured quads, so that changing the text requires
+// uploading only the glyphs which are not in the atlas yet.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_glyph_atlas;
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph atlas text definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_glyph_atlas_quad {
+    // Glyph's region in atlas' texture, and its region in text's space.
+    struct wlr_box source, target;
+};
+
+struct rose_glyph_atlas_text_line {
+    struct rose_glyph_atlas_quad quads[rose_utf32_string_size_max];
+    size_t size;
+};
+
+struct rose_glyph_atlas_text {
+    // Text's dimensions (in pixels).
+    int width, height;
+
+    // Flag: indicates that the text has been fully added to the atlas, and can
+    // be rendered.
+    bool is_valid;
+
+    // Text's lines.
+    int line_count;
+    struct rose_glyph_atlas_text_line lines[];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization/destruction interface.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_glyph_atlas*
+rose_glyph_atlas_initialize(struct wlr_renderer* renderer);
+
+void
+rose_glyph_atlas_destroy(struct rose_glyph_atlas* atlas);
+
+struct rose_glyph_atlas_text*
+rose_glyph_atlas_text_initialize(int line_count);
+
+void
+rose_glyph_atlas_text_destroy(struct rose_glyph_atlas_text* text);
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph manipulation interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Adds the given glyphs, colored with the given color, to the atlas, and
+// computes their quads. Targets of the quads are vertically offset by the given
+// amount of pixels.
+//
+// Note: Only the glyphs which are not in the atlas yet are rasterized. Returns
+// false if the atlas is full, in which case it must be reset.
+bool
+rose_glyph_atlas_add_glyphs(
+    struct rose_glyph_atlas* atlas,
+    struct rose_glyph_placement_list const* placements, struct rose_color color,
+    int dy, struct rose_glyph_atlas_text_line* line);
+
+// Uploads newly added glyphs (if any) to atlas' texture.
+void
+rose_glyph_atlas_flush(struct rose_glyph_atlas* atlas);
+
+// Removes all glyphs from the atlas. Quads which have been computed before the
+// reset are invalidated.
+void
+rose_glyph_atlas_reset(struct rose_glyph_atlas* atlas);
+
+bool
+rose_glyph_atlas_is_full(struct rose_glyph_atlas* atlas);
+
+////////////////////////////////////////////////////////////////////////////////
+// Texture access interface.
+////////////////////////////////////////////////////////////////////////////////
+
+struct wlr_texture*
+rose_glyph_atlas_obtain_texture(struct rose_glyph_atlas* atlas);
+
+#endif // H_5B0E4C8A27D34F1E9A6D3C71B8F2E940
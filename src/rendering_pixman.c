@@ -0,0 +1,97 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "rendering_pixman.h"
+#include "rendering_color_scheme.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_pixman_region_initialize(
+    pixman_region32_t* region, pixman_region32_t* clip_region,
+    pixman_box32_t box) {
+    // Initialize the region with the given box.
+    pixman_region32_init_rect(
+        region, box.x1, box.y1, (unsigned)(box.x2 - box.x1),
+        (unsigned)(box.y2 - box.y1));
+
+    // And clip it.
+    pixman_region32_intersect(region, region, clip_region);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Software composition interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_pixman_fill(
+    pixman_image_t* target, pixman_region32_t* clip_region, pixman_box32_t box,
+    struct rose_color color) {
+    // Do nothing if the box is empty, or if the color is fully transparent.
+    if((box.x1 >= box.x2) || (box.y1 >= box.y2) || (color.rgba8[3] == 0)) {
+        return;
+    }
+
+    // Compute the region which must be filled.
+    pixman_region32_t region;
+    rose_pixman_region_initialize(&region, clip_region, box);
+
+    // Fill it.
+    int n_boxes = 0;
+    pixman_box32_t* boxes = pixman_region32_rectangles(&region, &n_boxes);
+
+    if(n_boxes != 0) {
+        pixman_color_t pixman_color = {
+            .red = (uint16_t)(color.rgba32[0] * 0xFFFF),
+            .green = (uint16_t)(color.rgba32[1] * 0xFFFF),
+            .blue = (uint16_t)(color.rgba32[2] * 0xFFFF),
+            .alpha = (uint16_t)(color.rgba32[3] * 0xFFFF)};
+
+        pixman_image_fill_boxes(
+            ((color.rgba8[3] == 0xFF) ? PIXMAN_OP_SRC : PIXMAN_OP_OVER),
+            target, &pixman_color, n_boxes, boxes);
+    }
+
+    // Clean-up the region.
+    pixman_region32_fini(&region);
+}
+
+void
+rose_pixman_compose(
+    pixman_image_t* target, pixman_region32_t* clip_region,
+    pixman_image_t* source, int source_x, int source_y, pixman_box32_t box,
+    bool is_source_opaque) {
+    // Do nothing if the box is empty.
+    if((box.x1 >= box.x2) || (box.y1 >= box.y2)) {
+        return;
+    }
+
+    // Select composition operator.
+    pixman_op_t op =
+        ((is_source_opaque ||
+          (PIXMAN_FORMAT_A(pixman_image_get_format(source)) == 0))
+             ? PIXMAN_OP_SRC
+             : PIXMAN_OP_OVER);
+
+    // Compute the region which must be composed.
+    pixman_region32_t region;
+    rose_pixman_region_initialize(&region, clip_region, box);
+
+    // Compose each of its rectangles.
+    int n_boxes = 0;
+    pixman_box32_t* boxes = pixman_region32_rectangles(&region, &n_boxes);
+
+    for(int i = 0; i != n_boxes; ++i) {
+        pixman_image_composite32(
+            op, source, NULL, target, source_x + (boxes[i].x1 - box.x1),
+            source_y + (boxes[i].y1 - box.y1), 0, 0, boxes[i].x1, boxes[i].y1,
+            boxes[i].x2 - boxes[i].x1, boxes[i].y2 - boxes[i].y1);
+    }
+
+    // Clean-up the region.
+    pixman_region32_fini(&region);
+}
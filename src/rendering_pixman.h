@@ -0,0 +1,45 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_59C2102051764C689B88D2EC9D5CA68A
+#define H_59C2102051764C689B88D2EC9D5CA68A
+
+#include <pixman.h>
+#include <stdbool.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Forward declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_color;
+
+////////////////////////////////////////////////////////////////////////////////
+// Software composition interface.
+//
+// Note: These functions compose directly into the given target image, and
+// operate only on the rectangles of the intersection of the given box and the
+// given clipping region, so target's own clipping region is never used.
+// Coordinates are specified in target image's coordinate system.
+////////////////////////////////////////////////////////////////////////////////
+
+// Fills the given box with the given color. Opaque colors replace target's
+// pixels, while translucent ones are blended over them.
+void
+rose_pixman_fill(
+    pixman_image_t* target, pixman_region32_t* clip_region, pixman_box32_t box,
+    struct rose_color color);
+
+// Composes the given source image into the given box without scaling or
+// transformation. The given point of the source image is mapped to box's
+// top-left corner. If the source is opaque (either because the caller knows
+// so, or because its format has no alpha channel), then it replaces target's
+// pixels, otherwise it is blended over them.
+void
+rose_pixman_compose(
+    pixman_image_t* target, pixman_region32_t* clip_region,
+    pixman_image_t* source, int source_x, int source_y, pixman_box32_t box,
+    bool is_source_opaque);
+
+#endif // H_59C2102051764C689B88D2EC9D5CA68A
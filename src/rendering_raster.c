@@ -4,6 +4,7 @@
 // https://www.gnu.org/licenses/gpl-3.0.txt)
 //
 #include "rendering_raster.h"
+#include "metrics.h"
 
 #include <wlr/interfaces/wlr_buffer.h>
 #include <wlr/render/wlr_renderer.h>
@@ -57,6 +58,79 @@ static struct wlr_buffer_impl const rose_raster_buffer_implementation = {
     .begin_data_ptr_access = rose_raster_buffer_begin_data_ptr_access,
     .end_data_ptr_access = rose_raster_buffer_end_data_ptr_access};
 
+////////////////////////////////////////////////////////////////////////////////
+// Raster pool definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    // Maximum number of released rasters in the pool.
+    rose_raster_pool_size = 8,
+
+    // Maximum total size of pixel data of released rasters (in bytes).
+    rose_raster_pool_data_size_max = 64 * 1024 * 1024
+};
+
+struct rose_raster_pool {
+    // Renderer which is used to initialize textures.
+    struct wlr_renderer* renderer;
+
+    // Released rasters, from the least to the most recently released one.
+    struct rose_raster* rasters[rose_raster_pool_size];
+    ptrdiff_t raster_count;
+
+    // Total size of pixel data of released rasters.
+    size_t data_size;
+
+    // Metrics registry, if any.
+    struct rose_metrics* metrics;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Raster pool utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static int
+rose_raster_compute_size_class(int x) {
+    // Note: Size classes between (4 * step) and (8 * step) are multiples of the
+    // step, which limits wasted space to 25% in each dimension.
+    int step = 16;
+    while((step * 8) < x) {
+        step *= 2;
+    }
+
+    return min_(((x + step - 1) / step) * step, 32768);
+}
+
+static size_t
+rose_raster_compute_data_size(struct rose_raster* raster) {
+    return cast_(size_t, raster->base.width) *
+           cast_(size_t, raster->base.height) * 4U;
+}
+
+static void
+rose_raster_pool_count(
+    struct rose_raster_pool* pool, enum rose_metrics_counter_type type) {
+    if(pool->metrics != NULL) {
+        rose_metrics_counter_add(pool->metrics, type, 1);
+    }
+}
+
+static struct rose_raster*
+rose_raster_pool_remove(struct rose_raster_pool* pool, ptrdiff_t i) {
+    // Obtain the raster.
+    struct rose_raster* raster = pool->rasters[i];
+
+    // Remove it from the pool.
+    pool->data_size -= rose_raster_compute_data_size(raster);
+    pool->raster_count--;
+
+    for(; i != pool->raster_count; ++i) {
+        pool->rasters[i] = pool->rasters[i + 1];
+    }
+
+    return raster;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Initialization/destruction interface implementation.
 ////////////////////////////////////////////////////////////////////////////////
@@ -107,6 +181,10 @@ rose_raster_initialize_without_texture(int width, int height) {
         // Initialize raster's buffer interface.
         wlr_buffer_init(
             &(raster->base), &rose_raster_buffer_implementation, width, height);
+
+        // Use the whole raster.
+        raster->width = width;
+        raster->height = height;
     }
 
     // Clear the pixels.
@@ -129,6 +207,122 @@ rose_raster_destroy(struct rose_raster* raster) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Raster pool initialization/destruction interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_raster_pool*
+rose_raster_pool_initialize(
+    struct wlr_renderer* renderer, struct rose_metrics* metrics) {
+    // Allocate and initialize a new pool.
+    struct rose_raster_pool* pool = malloc(sizeof(struct rose_raster_pool));
+    if(pool != NULL) {
+        *pool = (struct rose_raster_pool){
+            .renderer = renderer, .metrics = metrics};
+    }
+
+    return pool;
+}
+
+void
+rose_raster_pool_destroy(struct rose_raster_pool* pool) {
+    if(pool != NULL) {
+        // Destroy all released rasters.
+        while(pool->raster_count != 0) {
+            rose_raster_destroy(rose_raster_pool_remove(pool, 0));
+        }
+
+        // Free memory.
+        free(pool);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Raster pool manipulation interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_raster*
+rose_raster_pool_acquire(struct rose_raster_pool* pool, int width, int height) {
+    // Clamp the dimensions.
+    width = clamp_(width, 1, 32768);
+    height = clamp_(height, 1, 32768);
+
+    // Compute dimensions of the raster which will be allocated if there is no
+    // suitable released raster.
+    int class_width = rose_raster_compute_size_class(width);
+    int class_height = rose_raster_compute_size_class(height);
+
+    // Find the smallest released raster which fits the given dimensions.
+    // Note: Rasters which are more than twice as large as newly allocated
+    // raster would be are not reused.
+    size_t data_size_max = cast_(size_t, class_width) *
+                           cast_(size_t, class_height) * 4U * 2U;
+
+    ptrdiff_t k = -1;
+    for(ptrdiff_t i = 0; i != pool->raster_count; ++i) {
+        struct rose_raster* raster = pool->rasters[i];
+        size_t data_size = rose_raster_compute_data_size(raster);
+
+        if((raster->base.width >= width) && (raster->base.height >= height) &&
+           (data_size <= data_size_max) &&
+           ((k == -1) ||
+            (data_size < rose_raster_compute_data_size(pool->rasters[k])))) {
+            k = i;
+        }
+    }
+
+    // Reuse the raster, if found. Otherwise, allocate a new one.
+    struct rose_raster* raster = NULL;
+    if(k != -1) {
+        raster = rose_raster_pool_remove(pool, k);
+        rose_raster_pool_count(pool, rose_metrics_counter_type_raster_reuses);
+    } else {
+        raster = rose_raster_initialize(
+            pool->renderer, class_width, class_height);
+        if(raster == NULL) {
+            return raster;
+        }
+
+        rose_raster_pool_count(
+            pool, rose_metrics_counter_type_raster_allocations);
+    }
+
+    // Set raster's region which is in use.
+    raster->width = width;
+    raster->height = height;
+
+    return raster;
+}
+
+void
+rose_raster_pool_release(
+    struct rose_raster_pool* pool, struct rose_raster* raster) {
+    // Do nothing if there is no raster.
+    if(raster == NULL) {
+        return;
+    }
+
+    // Destroy the raster if it can not be reused.
+    size_t data_size = rose_raster_compute_data_size(raster);
+    if((raster->texture == NULL) ||
+       (data_size > rose_raster_pool_data_size_max)) {
+        rose_raster_destroy(raster);
+        return;
+    }
+
+    // Evict the least recently released rasters, if needed.
+    while((pool->raster_count == rose_raster_pool_size) ||
+          ((pool->data_size + data_size) > rose_raster_pool_data_size_max)) {
+        rose_raster_destroy(rose_raster_pool_remove(pool, 0));
+        rose_raster_pool_count(
+            pool, rose_metrics_counter_type_raster_evictions);
+    }
+
+    // Add the raster to the pool.
+    pool->rasters[pool->raster_count++] = raster;
+    pool->data_size += data_size;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Pixel data clearing interface implementation.
 ////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,7 @@
 #define H_13A2516DF1AF47968C7A0CF09882D5CD
 
 #include <wlr/types/wlr_buffer.h>
+#include <stddef.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Forward declarations.
@@ -14,6 +15,7 @@
 
 struct wlr_renderer;
 struct wlr_texture;
+struct rose_metrics;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Raster definition.
@@ -26,10 +28,29 @@ struct rose_raster {
     // A texture which can be used in rendering.
     struct wlr_texture* texture;
 
+    // Dimensions of raster's region which is in use.
+    // Note: Rasters which are obtained from a pool might be larger than
+    // requested, in which case only their top-left region of requested size is
+    // used. Pixel data's pitch is always based on buffer's width.
+    int width, height;
+
     // Pixel data.
     unsigned char pixels[];
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Raster pool declaration.
+// Note: Pointer to this type shall be used as an opaque handle.
+//
+// Note: Pool keeps released rasters (along with their textures), and reuses
+// them when a raster of the same or smaller size is requested. New rasters are
+// allocated with dimensions rounded up to size classes, which increases the
+// chance of reuse. Allocations, reuses and evictions are counted in the
+// metrics registry, if the pool has been initialized with one.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_raster_pool;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Initialization/destruction interface.
 ////////////////////////////////////////////////////////////////////////////////
@@ -47,6 +68,34 @@ rose_raster_initialize_without_texture(int width, int height);
 void
 rose_raster_destroy(struct rose_raster* raster);
 
+////////////////////////////////////////////////////////////////////////////////
+// Raster pool initialization/destruction interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Metrics registry is optional, NULL is allowed.
+struct rose_raster_pool*
+rose_raster_pool_initialize(
+    struct wlr_renderer* renderer, struct rose_metrics* metrics);
+
+// Note: Rasters which have been acquired from the pool must be released before
+// pool's destruction.
+void
+rose_raster_pool_destroy(struct rose_raster_pool* pool);
+
+////////////////////////////////////////////////////////////////////////////////
+// Raster pool manipulation interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Returns a raster with a texture, which has the given dimensions. Contents of
+// raster's pixel data and its texture are unspecified.
+struct rose_raster*
+rose_raster_pool_acquire(struct rose_raster_pool* pool, int width, int height);
+
+// Note: The raster might be destroyed immediately. NULL is allowed.
+void
+rose_raster_pool_release(
+    struct rose_raster_pool* pool, struct rose_raster* raster);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Pixel data clearing interface.
 ////////////////////////////////////////////////////////////////////////////////
@@ -5,13 +5,17 @@
 //
 #include "memory.h"
 #include "rendering_text.h"
+#include "rendering_text_compositing.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
+#include FT_SIZES_H
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Helper macros.
@@ -24,6 +28,8 @@
 // Font definition.
 ////////////////////////////////////////////////////////////////////////////////
 
+enum { rose_font_count_max = 8 };
+
 struct rose_font {
     struct rose_memory memory;
     FT_Face ft_face;
@@ -67,6 +73,124 @@ rose_font_initialize(FT_Library ft, struct rose_memory memory) {
     return font;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Font index definition.
+//
+// Note: Font index maps each code point to the first font which contains it.
+// The index is a two-level table: each page maps a range of consecutive code
+// points to font indices (incremented by one, so that zero denotes a code point
+// which is not contained in any font). Pages are allocated on demand.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    rose_font_index_page_size = 256,
+    rose_font_index_page_count = 0x110000 / rose_font_index_page_size
+};
+
+struct rose_font_index {
+    unsigned char* pages[rose_font_index_page_count];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_glyph_key {
+    // Character's code point.
+    char32_t c;
+
+    // Index of the font which contains the character.
+    size_t font_index;
+
+    // Size parameters.
+    int font_size, dpi;
+};
+
+struct rose_glyph {
+    // Glyph's key.
+    struct rose_glyph_key key;
+
+    // Horizontal advance (in pixels).
+    FT_Pos advance_x;
+
+    // Position of bitmap's top-left corner relative to the pen position, and
+    // bitmap's size.
+    FT_Pos left, top, width, height;
+
+    // Coverage bitmap, 8 bit per pixel. Bitmap's pitch equals its width.
+    unsigned char* bitmap;
+
+    // Flag: indicates that glyph's bitmap has been rendered. Glyphs which have
+    // been loaded only for their metrics have no bitmap.
+    bool is_rendered;
+
+    // Indices of neighbouring glyphs in the LRU list, and index of the next
+    // glyph in the hash chain.
+    int lru_prev, lru_next, hash_next;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph loading type definition.
+//
+// Note: Glyph's metrics are computed without rasterization, and are identical
+// to the metrics of the rendered glyph.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_glyph_loading_type {
+    rose_glyph_loading_type_metrics,
+    rose_glyph_loading_type_bitmap
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph cache definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    // Note: Glyph cache must be able to hold all glyphs of the longest string
+    // along with the reference and ellipsis glyphs, since glyphs of the string
+    // which is currently being rendered must never be evicted.
+    rose_glyph_cache_size = 1024,
+    rose_glyph_cache_bucket_count = 2048
+};
+
+struct rose_glyph_cache {
+    // Cached glyphs.
+    struct rose_glyph glyphs[rose_glyph_cache_size];
+
+    // Hash table of glyph chains.
+    int buckets[rose_glyph_cache_bucket_count];
+
+    // The most and the least recently used glyphs.
+    int lru_head, lru_tail;
+
+    // Number of used glyph slots.
+    int size;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Text size definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum { rose_text_size_cache_size = 8 };
+
+struct rose_text_size {
+    // Size parameters.
+    int font_size, dpi;
+
+    // Size objects of all font faces, created on demand.
+    FT_Size ft_sizes[rose_font_count_max];
+
+    // Reference vertical space (computed from U+004D character).
+    FT_Pos y_min, y_max;
+
+    // Ellipsis character's metrics.
+    FT_Pos ellipsis_advance_x;
+    FT_BBox ellipsis_bounding_box;
+
+    // Time of the last use.
+    unsigned long long last_use_time;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Text rendering context definition.
 ////////////////////////////////////////////////////////////////////////////////
@@ -74,25 +198,64 @@ rose_font_initialize(FT_Library ft, struct rose_memory memory) {
 struct rose_text_rendering_context {
     FT_Library ft;
 
+    // Cache of size-dependent metrics.
+    struct rose_text_size sizes[rose_text_size_cache_size];
+    unsigned long long time;
+
+    // Glyph cache.
+    struct rose_glyph_cache glyph_cache;
+
+    // Statistics.
+    struct rose_text_rendering_statistics statistics;
+
+    // Glyph compositing kernel.
+    rose_compositing_kernel_fn composite;
+
+    // Font index.
+    struct rose_font_index font_index;
+
     size_t font_count;
     struct rose_font fonts[];
 };
 
+_Static_assert(
+    rose_glyph_cache_size > (rose_utf32_string_size_max + 2),
+    "glyph cache is too small");
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph set definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+    // Note: Glyph set holds at most half of the glyph cache, so that its
+    // glyphs are not evicted from the cache as soon as they are added.
+    rose_glyph_set_size_max = rose_glyph_cache_size / 2
+};
+
+struct rose_glyph_set {
+    // Size parameters of set's glyphs.
+    int font_size, dpi;
+
+    // Glyphs.
+    struct rose_glyph glyphs[rose_glyph_set_size_max];
+    size_t size;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Bounding box manipulating utility functions.
 ////////////////////////////////////////////////////////////////////////////////
 
 static FT_BBox
-rose_compute_bounding_box(FT_GlyphSlot glyph) {
+rose_compute_bounding_box(struct rose_glyph const* glyph) {
     if(glyph == NULL) {
         return (FT_BBox){};
     }
 
     return (FT_BBox){
-        .xMin = glyph->bitmap_left,
-        .yMin = glyph->bitmap_top - glyph->bitmap.rows,
-        .xMax = glyph->bitmap_left + glyph->bitmap.width,
-        .yMax = glyph->bitmap_top};
+        .xMin = glyph->left,
+        .yMin = glyph->top - glyph->height,
+        .xMax = glyph->left + glyph->width,
+        .yMax = glyph->top};
 }
 
 static FT_BBox
@@ -112,33 +275,427 @@ rose_compute_bounding_box_extent(FT_BBox bounding_box) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Glyph rendering utility function.
+// Font index manipulating utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_font_index_destroy(struct rose_font_index* index) {
+    for(ptrdiff_t i = 0; i != rose_font_index_page_count; ++i) {
+        index->pages[i] = (free(index->pages[i]), NULL);
+    }
+}
+
+static bool
+rose_font_index_add_font(
+    struct rose_font_index* index, FT_Face ft_face, size_t font_index) {
+    // Iterate through all code points in font's charmap.
+    FT_UInt glyph_index = 0;
+    for(FT_ULong c = FT_Get_First_Char(ft_face, &glyph_index); glyph_index != 0;
+        c = FT_Get_Next_Char(ft_face, c, &glyph_index)) {
+        // Skip invalid code points.
+        if(c >= 0x110000) {
+            continue;
+        }
+
+        // Obtain index's page, allocate it if needed.
+        unsigned char** page = &(index->pages[c / rose_font_index_page_size]);
+        if(*page == NULL) {
+            if((*page = calloc(rose_font_index_page_size, 1)) == NULL) {
+                return false;
+            }
+        }
+
+        // Map the code point to the font, if it hasn't been mapped to any of
+        // the preceding fonts.
+        if((*page)[c % rose_font_index_page_size] == 0) {
+            (*page)[c % rose_font_index_page_size] =
+                (unsigned char)(font_index + 1);
+        }
+    }
+
+    return true;
+}
+
+static size_t
+rose_font_index_find(struct rose_font_index const* index, char32_t c) {
+    // Obtain index's page.
+    unsigned char const* page =
+        ((c < 0x110000) ? index->pages[c / rose_font_index_page_size] : NULL);
+
+    // If there is no font which contains the given code point, then use the
+    // first font.
+    if((page == NULL) || (page[c % rose_font_index_page_size] == 0)) {
+        return 0;
+    }
+
+    return (size_t)(page[c % rose_font_index_page_size] - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph cache manipulating utility functions.
 ////////////////////////////////////////////////////////////////////////////////
 
-static FT_GlyphSlot
-rose_render_glyph(struct rose_text_rendering_context* context, char32_t c) {
-    // Find a font face which contains the given character's code point.
-    FT_Face ft_face = context->fonts[0].ft_face;
+static void
+rose_glyph_cache_initialize(struct rose_glyph_cache* cache) {
+    // Initialize an empty LRU list.
+    cache->lru_head = cache->lru_tail = -1;
+    cache->size = 0;
+
+    // Initialize empty hash chains.
+    for(ptrdiff_t i = 0; i != rose_glyph_cache_bucket_count; ++i) {
+        cache->buckets[i] = -1;
+    }
+}
+
+static void
+rose_glyph_cache_destroy(struct rose_glyph_cache* cache) {
+    for(int i = 0; i != cache->size; ++i) {
+        free(cache->glyphs[i].bitmap);
+    }
+}
+
+static size_t
+rose_glyph_key_hash(struct rose_glyph_key key) {
+    size_t hash = (size_t)(key.c) * 2654435761u;
+    hash ^= (size_t)(key.font_index) + 0x9E3779B9u + (hash << 6) + (hash >> 2);
+    hash ^= (size_t)(key.font_size) + 0x9E3779B9u + (hash << 6) + (hash >> 2);
+    hash ^= (size_t)(key.dpi) + 0x9E3779B9u + (hash << 6) + (hash >> 2);
+
+    return hash % rose_glyph_cache_bucket_count;
+}
+
+static bool
+rose_glyph_key_equal(struct rose_glyph_key a, struct rose_glyph_key b) {
+    return (a.c == b.c) && (a.font_index == b.font_index) &&
+           (a.font_size == b.font_size) && (a.dpi == b.dpi);
+}
 
-    for(size_t i = 0; i < context->font_count; ++i) {
-        if(FT_Get_Char_Index(context->fonts[i].ft_face, c) != 0) {
-            ft_face = context->fonts[i].ft_face;
+static uint64_t
+rose_glyph_key_compute_id(struct rose_glyph_key key) {
+    // Note: Code point occupies 21 bits, font index occupies 3 bits, font size
+    // and DPI occupy 16 bits each.
+    return ((uint64_t)(key.c) & 0x1FFFFF) |
+           (((uint64_t)(key.font_index) & 0x07) << 21) |
+           (((uint64_t)(key.font_size) & 0xFFFF) << 24) |
+           (((uint64_t)(key.dpi) & 0xFFFF) << 40);
+}
+
+static void
+rose_glyph_cache_lru_unlink(struct rose_glyph_cache* cache, int i) {
+    struct rose_glyph* glyph = &(cache->glyphs[i]);
+
+    if(glyph->lru_prev != -1) {
+        cache->glyphs[glyph->lru_prev].lru_next = glyph->lru_next;
+    } else {
+        cache->lru_head = glyph->lru_next;
+    }
+
+    if(glyph->lru_next != -1) {
+        cache->glyphs[glyph->lru_next].lru_prev = glyph->lru_prev;
+    } else {
+        cache->lru_tail = glyph->lru_prev;
+    }
+
+    glyph->lru_prev = glyph->lru_next = -1;
+}
+
+static void
+rose_glyph_cache_lru_push_front(struct rose_glyph_cache* cache, int i) {
+    struct rose_glyph* glyph = &(cache->glyphs[i]);
+
+    glyph->lru_prev = -1;
+    glyph->lru_next = cache->lru_head;
+
+    if(cache->lru_head != -1) {
+        cache->glyphs[cache->lru_head].lru_prev = i;
+    } else {
+        cache->lru_tail = i;
+    }
+
+    cache->lru_head = i;
+}
+
+static void
+rose_glyph_cache_evict(struct rose_glyph_cache* cache, int i) {
+    // Obtain the glyph.
+    struct rose_glyph* glyph = &(cache->glyphs[i]);
+
+    // Remove the glyph from its hash chain.
+    for(int* x = &(cache->buckets[rose_glyph_key_hash(glyph->key)]); *x != -1;
+        x = &(cache->glyphs[*x].hash_next)) {
+        if(*x == i) {
+            *x = glyph->hash_next;
             break;
         }
     }
 
-    // Render a glyph for the given character.
-    if(FT_Load_Char(ft_face, c, FT_LOAD_RENDER) != FT_Err_Ok) {
-        return NULL;
+    // Remove the glyph from the LRU list.
+    rose_glyph_cache_lru_unlink(cache, i);
+
+    // Free glyph's bitmap.
+    glyph->bitmap = (free(glyph->bitmap), NULL);
+}
+
+static struct rose_glyph*
+rose_glyph_cache_find(
+    struct rose_glyph_cache* cache, struct rose_glyph_key key) {
+    for(int i = cache->buckets[rose_glyph_key_hash(key)]; i != -1;
+        i = cache->glyphs[i].hash_next) {
+        if(rose_glyph_key_equal(cache->glyphs[i].key, key)) {
+            // Mark the glyph as the most recently used one.
+            rose_glyph_cache_lru_unlink(cache, i);
+            rose_glyph_cache_lru_push_front(cache, i);
+
+            return &(cache->glyphs[i]);
+        }
     }
 
-    // Validate rendered glyph's format.
-    if(ft_face->glyph->format != FT_GLYPH_FORMAT_BITMAP) {
+    return NULL;
+}
+
+static bool
+rose_glyph_copy_bitmap(struct rose_glyph* glyph, FT_GlyphSlot slot) {
+    // Obtain glyph bitmap's pitch.
+    FT_Pos bitmap_pitch =
+        ((slot->bitmap.pitch < 0) ? -(slot->bitmap.pitch)
+                                  : +(slot->bitmap.pitch));
+
+    // Update glyph's bitmap size.
+    glyph->width = min_((FT_Pos)(slot->bitmap.width), bitmap_pitch);
+    glyph->height = slot->bitmap.rows;
+
+    // Copy glyph's coverage bitmap.
+    if((glyph->width > 0) && (glyph->height > 0)) {
+        glyph->bitmap = malloc((size_t)(glyph->width * glyph->height));
+        if(glyph->bitmap == NULL) {
+            return false;
+        }
+
+        for(FT_Pos i = 0; i != glyph->height; ++i) {
+            memcpy(
+                glyph->bitmap + glyph->width * i,
+                slot->bitmap.buffer + bitmap_pitch * i,
+                (size_t)(glyph->width));
+        }
+    } else {
+        glyph->width = glyph->height = 0;
+    }
+
+    return (glyph->is_rendered = true);
+}
+
+// Note: The cache takes ownership of glyph's bitmap.
+static struct rose_glyph*
+rose_glyph_cache_add(struct rose_glyph_cache* cache, struct rose_glyph glyph) {
+    // Obtain a slot for the glyph: either use a free slot, or evict the least
+    // recently used glyph.
+    int i = cache->size;
+    if(i != rose_glyph_cache_size) {
+        cache->size++;
+    } else {
+        rose_glyph_cache_evict(cache, i = cache->lru_tail);
+    }
+
+    // Add the glyph to the cache.
+    if(true) {
+        size_t hash = rose_glyph_key_hash(glyph.key);
+
+        glyph.hash_next = cache->buckets[hash];
+        cache->buckets[hash] = i;
+    }
+
+    cache->glyphs[i] = glyph;
+    rose_glyph_cache_lru_push_front(cache, i);
+
+    return &(cache->glyphs[i]);
+}
+
+static struct rose_glyph const*
+rose_glyph_cache_insert(
+    struct rose_glyph_cache* cache, struct rose_glyph_key key,
+    FT_GlyphSlot slot, enum rose_glyph_loading_type type) {
+    // Initialize a new glyph.
+    // Note: If the glyph has not been rendered, then its bitmap's position and
+    // size are preset by FreeType.
+    struct rose_glyph glyph = {
+        .key = key,
+        .advance_x = (slot->advance.x / 64),
+        .left = slot->bitmap_left,
+        .top = slot->bitmap_top,
+        .width = slot->bitmap.width,
+        .height = slot->bitmap.rows,
+        .lru_prev = -1,
+        .lru_next = -1};
+
+    if((glyph.width <= 0) || (glyph.height <= 0)) {
+        glyph.width = glyph.height = 0;
+    }
+
+    // Copy glyph's coverage bitmap, if needed.
+    if(type == rose_glyph_loading_type_bitmap) {
+        if(!rose_glyph_copy_bitmap(&glyph, slot)) {
+            return NULL;
+        }
+    }
+
+    // Add the glyph to the cache.
+    return rose_glyph_cache_add(cache, glyph);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph rendering utility function.
+////////////////////////////////////////////////////////////////////////////////
+
+static struct rose_glyph const*
+rose_render_glyph(
+    struct rose_text_rendering_context* context, struct rose_text_size* size,
+    char32_t c, enum rose_glyph_loading_type type) {
+    // Find a font which contains the given character's code point.
+    size_t font_index = rose_font_index_find(&(context->font_index), c);
+
+    // Initialize glyph's key.
+    struct rose_glyph_key key = {
+        .c = c,
+        .font_index = font_index,
+        .font_size = size->font_size,
+        .dpi = size->dpi};
+
+    // Search the cache.
+    // Note: A cached glyph which has been loaded only for its metrics must be
+    // rendered if its bitmap is requested.
+    struct rose_glyph* glyph =
+        rose_glyph_cache_find(&(context->glyph_cache), key);
+
+    if((glyph != NULL) &&
+       (glyph->is_rendered || (type == rose_glyph_loading_type_metrics))) {
+        context->statistics.glyph_cache_hit_count++;
+        return glyph;
+    } else {
+        context->statistics.glyph_cache_miss_count++;
+    }
+
+    // Obtain font face.
+    FT_Face ft_face = context->fonts[font_index].ft_face;
+
+    // Activate face's size object, create it if needed.
+    if(true) {
+        FT_Size* ft_size = &(size->ft_sizes[font_index]);
+        if(*ft_size == NULL) {
+            if(FT_New_Size(ft_face, ft_size) != FT_Err_Ok) {
+                return (*ft_size = NULL), NULL;
+            }
+
+            // Note: If the size object can not be configured, then it is
+            // destroyed, so that the next call tries again.
+            FT_Activate_Size(*ft_size);
+            if(FT_Set_Char_Size(
+                   ft_face, 0, size->font_size * 64, size->dpi, size->dpi) !=
+               FT_Err_Ok) {
+                return FT_Done_Size(*ft_size), (*ft_size = NULL), NULL;
+            }
+        } else {
+            FT_Activate_Size(*ft_size);
+        }
+    }
+
+    // Load a glyph for the given character, render it if needed.
+    if(FT_Load_Char(
+           ft_face, c,
+           ((type == rose_glyph_loading_type_bitmap) ? FT_LOAD_RENDER
+                                                     : FT_LOAD_DEFAULT)) !=
+       FT_Err_Ok) {
         return NULL;
     }
 
-    // Return the glyph slot with rendered glyph.
-    return ft_face->glyph;
+    // Validate loaded glyph's format: rendered glyph must be a bitmap, glyph
+    // which has been loaded only for its metrics may also be an outline.
+    if(true) {
+        FT_Glyph_Format format = ft_face->glyph->format;
+
+        if((format != FT_GLYPH_FORMAT_BITMAP) &&
+           ((type == rose_glyph_loading_type_bitmap) ||
+            (format != FT_GLYPH_FORMAT_OUTLINE))) {
+            return NULL;
+        }
+    }
+
+    // If the glyph is already in the cache, then update its bitmap.
+    if(glyph != NULL) {
+        return (rose_glyph_copy_bitmap(glyph, ft_face->glyph) ? glyph : NULL);
+    }
+
+    // Otherwise, add loaded glyph to the cache.
+    return rose_glyph_cache_insert(
+        &(context->glyph_cache), key, ft_face->glyph, type);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Text size obtaining utility function.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_text_size_destroy(struct rose_text_size* size) {
+    for(ptrdiff_t i = 0; i != rose_font_count_max; ++i) {
+        if(size->ft_sizes[i] != NULL) {
+            size->ft_sizes[i] = (FT_Done_Size(size->ft_sizes[i]), NULL);
+        }
+    }
+}
+
+static struct rose_text_size*
+rose_text_size_obtain(
+    struct rose_text_rendering_context* context, int font_size, int dpi) {
+    // Update context's time.
+    context->time++;
+
+    // Search the cache, find the least recently used entry.
+    struct rose_text_size* result = &(context->sizes[0]);
+
+    for(ptrdiff_t i = 0; i != rose_text_size_cache_size; ++i) {
+        struct rose_text_size* size = &(context->sizes[i]);
+
+        if((size->last_use_time != 0) && (size->font_size == font_size) &&
+           (size->dpi == dpi)) {
+            return (size->last_use_time = context->time), size;
+        }
+
+        if(size->last_use_time < result->last_use_time) {
+            result = size;
+        }
+    }
+
+    // Destroy size objects of the least recently used entry.
+    rose_text_size_destroy(result);
+
+    // Compute size-dependent metrics.
+    *result = (struct rose_text_size){
+        .font_size = font_size, .dpi = dpi, .last_use_time = context->time};
+
+    // Compute reference vertical space.
+    if(true) {
+        struct rose_glyph const* glyph =
+            rose_render_glyph(
+                context, result, 0x4D, rose_glyph_loading_type_metrics);
+
+        if(glyph != NULL) {
+            result->y_min = glyph->top - glyph->height;
+            result->y_max = glyph->top;
+        }
+    }
+
+    // Compute ellipsis character's metrics.
+    if(true) {
+        struct rose_glyph const* glyph =
+            rose_render_glyph(
+                context, result, 0x2026, rose_glyph_loading_type_metrics);
+
+        if(glyph != NULL) {
+            result->ellipsis_advance_x = glyph->advance_x;
+            result->ellipsis_bounding_box = rose_compute_bounding_box(glyph);
+        }
+    }
+
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -146,7 +703,12 @@ rose_render_glyph(struct rose_text_rendering_context* context, char32_t c) {
 ////////////////////////////////////////////////////////////////////////////////
 
 struct rose_glyph_buffer {
-    FT_Glyph data[rose_utf32_string_size_max];
+    // Glyphs with their horizontal offsets.
+    struct {
+        struct rose_glyph const* glyph;
+        FT_Pos x;
+    } data[rose_utf32_string_size_max];
+
     size_t size;
 };
 
@@ -172,21 +734,19 @@ rose_render_string_glyphs(
     // Limit string size.
     string.size = min_(string.size, rose_utf32_string_size_max);
 
-    // Set font size.
-    for(size_t i = 0; i < context->font_count; ++i) {
-        FT_Set_Char_Size(
-            context->fonts[i].ft_face, 0, parameters.font_size * 64,
-            parameters.dpi, parameters.dpi);
-    }
+    // Obtain size-dependent metrics.
+    struct rose_text_size* size =
+        rose_text_size_obtain(context, parameters.font_size, parameters.dpi);
 
-    // Compute reference space for the string.
-    if(true) {
-        FT_GlyphSlot glyph = rose_render_glyph(context, 0x4D);
-        if(glyph != NULL) {
-            result.y_min = glyph->bitmap_top - glyph->bitmap.rows;
-            result.y_max = glyph->bitmap_top;
-        }
-    }
+    // Glyphs are rendered only if they are added to the glyph buffer,
+    // otherwise only their metrics are needed.
+    enum rose_glyph_loading_type type =
+        ((glyph_buffer == NULL) ? rose_glyph_loading_type_metrics
+                                : rose_glyph_loading_type_bitmap);
+
+    // Set reference space for the string.
+    result.y_min = size->y_min;
+    result.y_max = size->y_max;
 
     // Initialize bounding box for the string.
     result.bounding_box =
@@ -202,32 +762,15 @@ rose_render_string_glyphs(
     FT_Pos max_width =
         ((parameters.max_width <= 0) ? INT_MAX : parameters.max_width);
 
-    // Initialize ellipsis character data.
-    struct {
-        FT_Glyph glyph;
-
-        FT_Pos advance_x;
-        FT_BBox bounding_box;
-    } ellipsis_character = {};
-
-    if(glyph_buffer != NULL) {
-        FT_GlyphSlot glyph = rose_render_glyph(context, 0x2026);
-        if(glyph != NULL) {
-            if(FT_Get_Glyph(glyph, &(ellipsis_character.glyph)) == FT_Err_Ok) {
-                ellipsis_character.advance_x = (glyph->advance.x / 64);
-                ellipsis_character.bounding_box =
-                    rose_compute_bounding_box(glyph);
-            }
-        }
-    }
-
     // Initialize pen position.
     FT_Pos pen_position = 0;
 
     // Render string characters.
     for(size_t i = 0, j = 0; i < string.size; ++i) {
         // Render current character.
-        FT_GlyphSlot glyph = rose_render_glyph(context, string.data[i]);
+        struct rose_glyph const* glyph =
+            rose_render_glyph(context, size, string.data[i], type);
+
         if(glyph == NULL) {
             continue;
         }
@@ -240,24 +783,24 @@ rose_render_string_glyphs(
         // If there is no glyph buffer specified, then advance pen position and
         // move to the next character.
         if(glyph_buffer == NULL) {
-            pen_position += (glyph->advance.x / 64);
+            pen_position += glyph->advance_x;
             continue;
         }
 
         // Check string's width.
         if((result.bounding_box.xMax - result.bounding_box.xMin) > max_width) {
             // If it exceeds horizontal bound, then start backtracking and find
-            // a position which can fit the rendered ellipsis character.
+            // a position which can fit the ellipsis character.
             for(j = 0; glyph_buffer->size > 0;) {
-                // Destroy the last glyph.
-                FT_Done_Glyph(glyph_buffer->data[j = --(glyph_buffer->size)]);
+                // Remove the last glyph.
+                j = --(glyph_buffer->size);
 
                 // Restore pen position.
                 pen_position = history[j].pen_position;
 
                 // Compute string's bounding box.
                 result.bounding_box = rose_stretch_bounding_box(
-                    history[j].bounding_box, ellipsis_character.bounding_box,
+                    history[j].bounding_box, size->ellipsis_bounding_box,
                     pen_position);
 
                 // If the string fits, then break out of the cycle.
@@ -272,21 +815,18 @@ rose_render_string_glyphs(
             // bounding box.
             if(j == 0) {
                 pen_position = history[0].pen_position;
-                result.bounding_box = ellipsis_character.bounding_box;
+                result.bounding_box = size->ellipsis_bounding_box;
             }
 
-            // Add rendered ellipsis glyph to the glyph buffer.
-            if(ellipsis_character.glyph != NULL) {
-                if(FT_Glyph_Copy(
-                       ellipsis_character.glyph, &(glyph_buffer->data[j])) ==
-                   FT_Err_Ok) {
-                    // Compute glyph's offset.
-                    ((FT_BitmapGlyph)(glyph_buffer->data[j]))->left +=
-                        pen_position;
-
-                    // Increment the number of glyphs in the glyph buffer.
-                    glyph_buffer->size = ++j;
-                }
+            // Add ellipsis glyph to the glyph buffer.
+            glyph = rose_render_glyph(context, size, 0x2026, type);
+
+            if(glyph != NULL) {
+                glyph_buffer->data[j].glyph = glyph;
+                glyph_buffer->data[j].x = pen_position;
+
+                // Increment the number of glyphs in the glyph buffer.
+                glyph_buffer->size = ++j;
             }
 
             // And break out of the cycle.
@@ -294,25 +834,18 @@ rose_render_string_glyphs(
         }
 
         // Add rendered glyph to the glyph buffer.
-        if(FT_Get_Glyph(glyph, &(glyph_buffer->data[j])) == FT_Err_Ok) {
-            // Compute glyph's offset.
-            ((FT_BitmapGlyph)(glyph_buffer->data[j]))->left += pen_position;
+        glyph_buffer->data[j].glyph = glyph;
+        glyph_buffer->data[j].x = pen_position;
 
-            // Save current pen position and string's bounding box.
-            history[j].pen_position = pen_position;
-            history[j].bounding_box = result.bounding_box;
+        // Save current pen position and string's bounding box.
+        history[j].pen_position = pen_position;
+        history[j].bounding_box = result.bounding_box;
 
-            // Increment the number of glyphs in the glyph buffer.
-            glyph_buffer->size = ++j;
-        }
+        // Increment the number of glyphs in the glyph buffer.
+        glyph_buffer->size = ++j;
 
         // Advance pen position.
-        pen_position += (glyph->advance.x / 64);
-    }
-
-    // Free memory.
-    if(ellipsis_character.glyph != NULL) {
-        FT_Done_Glyph(ellipsis_character.glyph);
+        pen_position += glyph->advance_x;
     }
 
     return result;
@@ -331,7 +864,8 @@ rose_text_rendering_context_initialize(
     }
 
     // Check the parameters.
-    if((parameters.font_count == 0) || (parameters.font_count > 8)) {
+    if((parameters.font_count == 0) ||
+       (parameters.font_count > rose_font_count_max)) {
         free_font_data_;
         return NULL;
     }
@@ -343,12 +877,15 @@ rose_text_rendering_context_initialize(
 
     if(context != NULL) {
         *context = (struct rose_text_rendering_context){
+            .composite = rose_compositing_kernel_select(),
             .font_count = parameters.font_count};
 
         for(size_t i = 0; i != parameters.font_count; ++i) {
             context->fonts[i] =
                 (struct rose_font){.memory = parameters.fonts[i]};
         }
+
+        rose_glyph_cache_initialize(&(context->glyph_cache));
     } else {
         free_font_data_;
         return NULL;
@@ -371,6 +908,14 @@ rose_text_rendering_context_initialize(
         }
     }
 
+    // Build font index.
+    for(size_t i = 0; i != context->font_count; ++i) {
+        if(!rose_font_index_add_font(
+               &(context->font_index), context->fonts[i].ft_face, i)) {
+            return (rose_text_rendering_context_destroy(context), NULL);
+        }
+    }
+
     return context;
 }
 
@@ -378,6 +923,15 @@ void
 rose_text_rendering_context_destroy(
     struct rose_text_rendering_context* context) {
     if(context != NULL) {
+        // Destroy glyph cache and font index.
+        rose_glyph_cache_destroy(&(context->glyph_cache));
+        rose_font_index_destroy(&(context->font_index));
+
+        // Destroy size objects.
+        for(ptrdiff_t i = 0; i != rose_text_size_cache_size; ++i) {
+            rose_text_size_destroy(&(context->sizes[i]));
+        }
+
         // Destroy fonts.
         for(size_t i = 0; i != context->font_count; ++i) {
             rose_font_destroy(&(context->fonts[i]));
@@ -393,6 +947,217 @@ rose_text_rendering_context_destroy(
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Statistics query interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_text_rendering_statistics
+rose_text_rendering_statistics_obtain(
+    struct rose_text_rendering_context* context) {
+    return context->statistics;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph set manipulation utility function.
+////////////////////////////////////////////////////////////////////////////////
+
+// Adds the glyph of the given character to the set, if it is not in context's
+// glyph cache. Returns true if the glyph is not cached.
+static bool
+rose_glyph_set_add(
+    struct rose_text_rendering_context* context, struct rose_glyph_set* set,
+    char32_t c, bool must_be_rendered) {
+    // Initialize glyph's key.
+    struct rose_glyph_key key = {
+        .c = c,
+        .font_index = rose_font_index_find(&(context->font_index), c),
+        .font_size = set->font_size,
+        .dpi = set->dpi};
+
+    // Do nothing else if the glyph is cached.
+    if(true) {
+        struct rose_glyph* glyph =
+            rose_glyph_cache_find(&(context->glyph_cache), key);
+
+        if((glyph != NULL) && (glyph->is_rendered || !must_be_rendered)) {
+            return false;
+        }
+    }
+
+    // Do nothing else if the glyph has already been added to the set.
+    for(size_t i = 0; i != set->size; ++i) {
+        if(rose_glyph_key_equal(set->glyphs[i].key, key)) {
+            return true;
+        }
+    }
+
+    // Add the glyph to the set, if possible.
+    if(set->size != rose_glyph_set_size_max) {
+        set->glyphs[set->size++] = (struct rose_glyph){.key = key};
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph set initialization/destruction interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_glyph_set*
+rose_glyph_set_initialize(int font_size, int dpi) {
+    // Allocate and initialize an empty set.
+    struct rose_glyph_set* set = malloc(sizeof(struct rose_glyph_set));
+    if(set != NULL) {
+        set->font_size = font_size;
+        set->dpi = dpi;
+        set->size = 0;
+    }
+
+    return set;
+}
+
+void
+rose_glyph_set_destroy(struct rose_glyph_set* set) {
+    if(set != NULL) {
+        // Free glyphs' bitmaps.
+        for(size_t i = 0; i != set->size; ++i) {
+            free(set->glyphs[i].bitmap);
+        }
+
+        // Free memory.
+        free(set);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph set manipulation interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+bool
+rose_glyph_set_add_strings(
+    struct rose_text_rendering_context* context, struct rose_glyph_set* set,
+    struct rose_utf32_string const* strings, size_t string_count) {
+    // Note: Reference character's glyph is always needed for its metrics,
+    // ellipsis character's glyph is rendered when a string is truncated.
+    bool result = rose_glyph_set_add(context, set, 0x4D, false);
+    result = rose_glyph_set_add(context, set, 0x2026, true) || result;
+
+    // Add glyphs of the strings.
+    for(size_t i = 0; i != string_count; ++i) {
+        size_t n = min_(strings[i].size, rose_utf32_string_size_max);
+        for(size_t j = 0; j != n; ++j) {
+            result =
+                rose_glyph_set_add(context, set, strings[i].data[j], true) ||
+                result;
+        }
+    }
+
+    return result;
+}
+
+bool
+rose_glyph_set_is_empty(struct rose_glyph_set* set) {
+    return (set->size == 0);
+}
+
+void
+rose_glyph_set_render(
+    struct rose_text_rendering_context* context, struct rose_glyph_set* set) {
+    // Obtain size-dependent metrics.
+    struct rose_text_size* size =
+        rose_text_size_obtain(context, set->font_size, set->dpi);
+
+    // Render the glyphs.
+    for(size_t i = 0; i != set->size; ++i) {
+        // Obtain current glyph.
+        struct rose_glyph* x = &(set->glyphs[i]);
+
+        // Skip the glyph if it has already been rendered.
+        if(x->is_rendered) {
+            continue;
+        }
+
+        // Render the glyph.
+        struct rose_glyph const* glyph = rose_render_glyph(
+            context, size, x->key.c, rose_glyph_loading_type_bitmap);
+
+        if(glyph == NULL) {
+            continue;
+        }
+
+        // Copy glyph's metrics.
+        *x = (struct rose_glyph){
+            .key = glyph->key,
+            .advance_x = glyph->advance_x,
+            .left = glyph->left,
+            .top = glyph->top,
+            .width = glyph->width,
+            .height = glyph->height};
+
+        // Copy glyph's coverage bitmap.
+        if((x->width > 0) && (x->height > 0)) {
+            size_t bitmap_size = (size_t)(x->width * x->height);
+            if((x->bitmap = malloc(bitmap_size)) == NULL) {
+                continue;
+            }
+
+            memcpy(x->bitmap, glyph->bitmap, bitmap_size);
+        }
+
+        // Mark the glyph as rendered.
+        x->is_rendered = true;
+    }
+}
+
+void
+rose_glyph_set_insert(
+    struct rose_text_rendering_context* context, struct rose_glyph_set* set) {
+    for(size_t i = 0; i != set->size; ++i) {
+        // Obtain current glyph, skip it if it has not been rendered.
+        struct rose_glyph* x = &(set->glyphs[i]);
+        if(!(x->is_rendered)) {
+            continue;
+        }
+
+        // Search the cache.
+        struct rose_glyph* glyph =
+            rose_glyph_cache_find(&(context->glyph_cache), x->key);
+
+        if(glyph != NULL) {
+            // If the glyph has been loaded only for its metrics, then update
+            // its bitmap.
+            if(!(glyph->is_rendered)) {
+                glyph->width = x->width;
+                glyph->height = x->height;
+                glyph->bitmap = x->bitmap;
+                glyph->is_rendered = true;
+
+                x->bitmap = NULL;
+            }
+
+            continue;
+        }
+
+        // Otherwise, add the glyph to the cache. The cache takes ownership of
+        // glyph's bitmap.
+        rose_glyph_cache_add(
+            &(context->glyph_cache),
+            (struct rose_glyph){
+                .key = x->key,
+                .advance_x = x->advance_x,
+                .left = x->left,
+                .top = x->top,
+                .width = x->width,
+                .height = x->height,
+                .bitmap = x->bitmap,
+                .is_rendered = true,
+                .lru_prev = -1,
+                .lru_next = -1});
+
+        x->bitmap = NULL;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Text rendering interface implementation.
 ////////////////////////////////////////////////////////////////////////////////
@@ -402,7 +1167,8 @@ rose_compute_string_extent(
     struct rose_text_rendering_context* context,
     struct rose_text_rendering_parameters parameters,
     struct rose_utf32_string string) {
-    // Render glyphs from the string and obtain string's bounding box.
+    // Load metrics of glyphs from the string (without rendering them) and
+    // obtain string's bounding box.
     FT_BBox bounding_box =
         rose_render_string_glyphs(context, parameters, string, NULL)
             .bounding_box;
@@ -417,28 +1183,18 @@ rose_compute_string_extent(
 }
 
 struct rose_text_rendering_extent
-rose_render_string(
+rose_place_string(
     struct rose_text_rendering_context* context,
     struct rose_text_rendering_parameters parameters,
-    struct rose_utf32_string string, //
-    struct rose_pixel_buffer pixel_buffer) {
-    struct rose_text_rendering_extent result = {};
-
-    // Obtain color.
-    unsigned color[] = {
-        parameters.color.rgba8[2], parameters.color.rgba8[1],
-        parameters.color.rgba8[0]};
+    struct rose_utf32_string string, int width, int height,
+    struct rose_glyph_placement_list* placements) {
+    // Initialize an empty list of placements.
+    placements->size = 0;
 
     // Compute horizontal bound.
     parameters.max_width =
-        ((parameters.max_width > 0)
-             ? min_(pixel_buffer.width, parameters.max_width)
-             : pixel_buffer.width);
-
-    // Compute pixel buffer's pitch, if needed.
-    if(pixel_buffer.pitch <= 0) {
-        pixel_buffer.pitch = pixel_buffer.width * 4;
-    }
+        ((parameters.max_width > 0) ? min_(width, parameters.max_width)
+                                    : width);
 
     // Initialize an empty glyph buffer.
     struct rose_glyph_buffer glyph_buffer = {};
@@ -450,95 +1206,114 @@ rose_render_string(
     // Validate string's bounding box.
     if((string_metrics.bounding_box.xMax < string_metrics.bounding_box.xMin) ||
        (string_metrics.bounding_box.yMax < string_metrics.bounding_box.yMin)) {
-        goto cleanup;
+        return (struct rose_text_rendering_extent){};
     }
 
-    // Render string to the pixel buffer.
+    // Compute baseline's offset.
+    FT_Pos dx_baseline = -string_metrics.bounding_box.xMin;
+    FT_Pos dy_baseline = -string_metrics.y_min;
+
+    // Center the baseline.
     if(true) {
-        // Compute baseline's offset.
-        FT_Pos dx_baseline = -string_metrics.bounding_box.xMin;
-        FT_Pos dy_baseline = -string_metrics.y_min;
-
-        // Center the baseline.
-        if(true) {
-            // Compute string's reference height.
-            FT_Pos height = (string_metrics.y_max - string_metrics.y_min);
-
-            // Update the baseline.
-            if(pixel_buffer.height > height) {
-                if(string_metrics.y_min < 0) {
-                    height -= string_metrics.y_min;
-                }
+        // Compute string's reference height.
+        FT_Pos reference_height = (string_metrics.y_max - string_metrics.y_min);
 
-                dy_baseline += (pixel_buffer.height - height) / 2;
+        // Update the baseline.
+        if(height > reference_height) {
+            if(string_metrics.y_min < 0) {
+                reference_height -= string_metrics.y_min;
             }
+
+            dy_baseline += (height - reference_height) / 2;
         }
+    }
 
-        // Copy each rendered character to the pixel buffer.
-        for(size_t i = 0; i < glyph_buffer.size; ++i) {
-            // Obtain current glyph.
-            FT_BitmapGlyph glyph = (FT_BitmapGlyph)(glyph_buffer.data[i]);
+    // Place each rendered glyph.
+    for(size_t i = 0; i < glyph_buffer.size; ++i) {
+        // Obtain current glyph.
+        struct rose_glyph const* glyph = glyph_buffer.data[i].glyph;
 
-            // Compute offsets.
-            FT_Pos dx_target = glyph->left + dx_baseline;
-            FT_Pos dy_target = pixel_buffer.height - glyph->top - dy_baseline;
+        // Compute offsets.
+        FT_Pos dx_target = glyph->left + glyph_buffer.data[i].x + dx_baseline;
+        FT_Pos dy_target = height - glyph->top - dy_baseline;
 
-            FT_Pos dy_source = ((dy_target < 0) ? -dy_target : 0);
-            dy_target = max_(0, dy_target);
+        FT_Pos dy_source = ((dy_target < 0) ? -dy_target : 0);
+        dy_target = max_(0, dy_target);
 
-            // Compute target width based on glyph bitmap's width and the amount
-            // of space left in the pixel buffer.
-            FT_Pos width = glyph->bitmap.width;
-            if(true) {
-                FT_Pos space = pixel_buffer.width - dx_target;
-                width = min_(width, space);
-            }
+        // Compute target width based on glyph bitmap's width and the amount of
+        // space left in the pixel buffer.
+        FT_Pos target_width = min_(glyph->width, width - dx_target);
 
-            // Compute target height based on glyph bitmap's height and the
-            // amount of space left in the pixel buffer.
-            FT_Pos height = glyph->bitmap.rows - dy_source;
-            if(true) {
-                FT_Pos space = pixel_buffer.height - dy_target;
-                height = min_(height, space);
-            }
+        // Compute target height based on glyph bitmap's height and the amount
+        // of space left in the pixel buffer.
+        FT_Pos target_height =
+            min_(glyph->height - dy_source, height - dy_target);
 
-            // Compute glyph bitmap's pitch.
-            FT_Pos bitmap_pitch =
-                ((glyph->bitmap.pitch < 0) ? -(glyph->bitmap.pitch)
-                                           : +(glyph->bitmap.pitch));
-
-            // Render glyph's bitmap to the pixel buffer.
-            if((width > 0) && (height > 0)) {
-                unsigned char* bitmap_buffer =
-                    glyph->bitmap.buffer + bitmap_pitch * dy_source;
-
-                for(FT_Pos j = dy_target; j < (dy_target + height);
-                    ++j, bitmap_buffer += bitmap_pitch) {
-                    unsigned char* source = bitmap_buffer;
-                    unsigned char* target = pixel_buffer.data +
-                                            pixel_buffer.pitch * j +
-                                            4 * dx_target;
-
-                    for(int k = 0; k != width; ++k) {
-                        unsigned char c = *(source++);
-                        *(target++) = (unsigned char)((color[0] * c) / 255);
-                        *(target++) = (unsigned char)((color[1] * c) / 255);
-                        *(target++) = (unsigned char)((color[2] * c) / 255);
-                        *(target++) = c;
-                    }
-                }
-            }
+        // Skip the glyph if it is not visible.
+        if((target_width <= 0) || (target_height <= 0)) {
+            continue;
         }
+
+        // Add glyph's placement to the list.
+        placements->data[placements->size++] = (struct rose_glyph_placement){
+            .id = rose_glyph_key_compute_id(glyph->key),
+            .bitmap = glyph->bitmap,
+            .bitmap_width = (int)(glyph->width),
+            .bitmap_height = (int)(glyph->height),
+            .dx = 0,
+            .dy = (int)(dy_source),
+            .x = (int)(dx_target),
+            .y = (int)(dy_target),
+            .width = (int)(target_width),
+            .height = (int)(target_height)};
     }
 
     // Compute string's extent.
-    result = rose_compute_bounding_box_extent(string_metrics.bounding_box);
+    return rose_compute_bounding_box_extent(string_metrics.bounding_box);
+}
 
-cleanup:
-    // Free memory and return the result.
-    for(size_t i = 0; i < glyph_buffer.size; ++i) {
-        FT_Done_Glyph(glyph_buffer.data[i]);
+struct rose_text_rendering_extent
+rose_render_string(
+    struct rose_text_rendering_context* context,
+    struct rose_text_rendering_parameters parameters,
+    struct rose_utf32_string string, //
+    struct rose_pixel_buffer pixel_buffer) {
+    // Obtain color in ARGB8888 format.
+    uint32_t color = ((uint32_t)(parameters.color.rgba8[0]) << 16) |
+                     ((uint32_t)(parameters.color.rgba8[1]) << 8) |
+                     ((uint32_t)(parameters.color.rgba8[2]));
+
+    // Compute pixel buffer's pitch, if needed.
+    if(pixel_buffer.pitch <= 0) {
+        pixel_buffer.pitch = pixel_buffer.width * 4;
     }
 
-    return result;
+    // Place string's glyphs in the pixel buffer.
+    struct rose_glyph_placement_list placements;
+    struct rose_text_rendering_extent extent = rose_place_string(
+        context, parameters, string, pixel_buffer.width, pixel_buffer.height,
+        &placements);
+
+    // Render each placed glyph to the pixel buffer.
+    for(size_t i = 0; i < placements.size; ++i) {
+        // Obtain current glyph's placement.
+        struct rose_glyph_placement* placement = &(placements.data[i]);
+
+        // Obtain the first row of glyph's visible part.
+        unsigned char const* bitmap_buffer =
+            placement->bitmap + placement->bitmap_width * placement->dy +
+            placement->dx;
+
+        // Render the rows.
+        for(int j = placement->y; j < (placement->y + placement->height);
+            ++j, bitmap_buffer += placement->bitmap_width) {
+            unsigned char* target = pixel_buffer.data +
+                                    pixel_buffer.pitch * j + 4 * placement->x;
+
+            context->composite(
+                target, bitmap_buffer, (size_t)(placement->width), color);
+        }
+    }
+
+    return extent;
 }
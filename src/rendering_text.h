@@ -8,6 +8,8 @@
 
 #include "rendering_color_scheme.h"
 #include "unicode.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Forward declarations.
@@ -22,6 +24,17 @@ struct rose_memory;
 
 struct rose_text_rendering_context;
 
+////////////////////////////////////////////////////////////////////////////////
+// Glyph set declaration.
+// Note: Pointer to this type shall be used as an opaque handle.
+//
+// Note: Glyph set transfers rendered glyphs from one text rendering context to
+// the glyph cache of another, which allows rendering glyphs in a separate
+// thread. Both contexts must be initialized with the same fonts.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_glyph_set;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Text rendering context initialization parameters definition.
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,6 +65,40 @@ struct rose_text_rendering_extent {
     int width, height;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Text rendering statistics definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_text_rendering_statistics {
+    // Number of glyph cache hits and misses.
+    size_t glyph_cache_hit_count, glyph_cache_miss_count;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph placement definition. This type is used as a result of string's layout
+// computation.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_glyph_placement {
+    // Glyph's identifier, unique within text rendering context.
+    uint64_t id;
+
+    // Glyph's coverage bitmap, 8 bit per pixel (bitmap's pitch equals its
+    // width), and bitmap's size.
+    // Note: Bitmap is valid until the next text rendering operation.
+    unsigned char const* bitmap;
+    int bitmap_width, bitmap_height;
+
+    // Visible part of the bitmap: its offset in the bitmap, its position in the
+    // target pixel buffer, and its size.
+    int dx, dy, x, y, width, height;
+};
+
+struct rose_glyph_placement_list {
+    struct rose_glyph_placement data[rose_utf32_string_size_max];
+    size_t size;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Pixel buffer definition. This type is used as a target for rendering.
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,6 +127,52 @@ void
 rose_text_rendering_context_destroy(
     struct rose_text_rendering_context* context);
 
+////////////////////////////////////////////////////////////////////////////////
+// Statistics query interface.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_text_rendering_statistics
+rose_text_rendering_statistics_obtain(
+    struct rose_text_rendering_context* context);
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph set initialization/destruction interface.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_glyph_set*
+rose_glyph_set_initialize(int font_size, int dpi);
+
+void
+rose_glyph_set_destroy(struct rose_glyph_set* set);
+
+////////////////////////////////////////////////////////////////////////////////
+// Glyph set manipulation interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Adds glyphs of the given strings which are not in context's glyph cache to
+// the set. Returns true if the strings have such glyphs.
+//
+// Note: The set has limited capacity, so some of the glyphs might not be added.
+bool
+rose_glyph_set_add_strings(
+    struct rose_text_rendering_context* context, struct rose_glyph_set* set,
+    struct rose_utf32_string const* strings, size_t string_count);
+
+bool
+rose_glyph_set_is_empty(struct rose_glyph_set* set);
+
+// Renders set's glyphs using the given context.
+// Note: This function can be called from any thread, as long as neither the
+// context nor the set are used concurrently.
+void
+rose_glyph_set_render(
+    struct rose_text_rendering_context* context, struct rose_glyph_set* set);
+
+// Adds rendered glyphs of the set to context's glyph cache.
+void
+rose_glyph_set_insert(
+    struct rose_text_rendering_context* context, struct rose_glyph_set* set);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Text rendering interface.
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,6 +183,15 @@ rose_compute_string_extent(
     struct rose_text_rendering_parameters parameters,
     struct rose_utf32_string string);
 
+// Note: This function computes placement of string's glyphs in a pixel buffer
+// of the given size, but does not render the string.
+struct rose_text_rendering_extent
+rose_place_string(
+    struct rose_text_rendering_context* context,
+    struct rose_text_rendering_parameters parameters,
+    struct rose_utf32_string string, int width, int height,
+    struct rose_glyph_placement_list* placements);
+
 struct rose_text_rendering_extent
 rose_render_string(
     struct rose_text_rendering_context* context,
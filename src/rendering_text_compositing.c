@@ -0,0 +1,228 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "rendering_text_compositing.h"
+
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define ROSE_COMPOSITING_X86_64 1
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar kernel implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+static unsigned
+rose_divide_by_255(unsigned x) {
+    // Note: Computes correctly rounded x/255 for x in [0, 255*255].
+    return (x += 128), ((x + (x >> 8)) >> 8);
+}
+
+static void
+rose_composite_scalar(
+    unsigned char* target, unsigned char const* coverage, size_t size,
+    uint32_t color) {
+    // Obtain color's channels in target's byte order.
+    unsigned const channels[] = {
+        (color & 0xFF), ((color >> 8) & 0xFF), ((color >> 16) & 0xFF), 0xFF};
+
+    // Composite each pixel.
+    for(size_t i = 0; i != size; ++i, target += 4) {
+        // Obtain pixel's coverage, skip fully transparent pixels.
+        unsigned c = coverage[i];
+        if(c == 0) {
+            continue;
+        }
+
+        // Compute resulting pixel: source + target * (1 - source_alpha).
+        for(ptrdiff_t j = 0; j != 4; ++j) {
+            target[j] = (unsigned char)(
+                rose_divide_by_255(channels[j] * c) +
+                rose_divide_by_255(target[j] * (255 - c)));
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE2 kernel implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef ROSE_COMPOSITING_X86_64
+
+static inline __m128i
+rose_divide_by_255_sse2(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+static inline __m128i
+rose_composite_pixels_sse2(__m128i color, __m128i c, __m128i target) {
+    return _mm_add_epi16(
+        rose_divide_by_255_sse2(_mm_mullo_epi16(color, c)),
+        rose_divide_by_255_sse2(_mm_mullo_epi16(
+            target, _mm_sub_epi16(_mm_set1_epi16(255), c))));
+}
+
+static void
+rose_composite_sse2(
+    unsigned char* target, unsigned char const* coverage, size_t size,
+    uint32_t color) {
+    // Expand color's channels to 16 bit lanes (two pixels per register).
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const color16 = _mm_unpacklo_epi8(
+        _mm_set1_epi32((int)(color | 0xFF000000u)), zero);
+
+    // Composite four pixels per iteration.
+    size_t i = 0;
+    for(; (i + 4) <= size; i += 4, target += 16) {
+        // Obtain coverage, skip fully transparent pixels.
+        uint32_t c32 = 0;
+        memcpy(&c32, coverage + i, sizeof(c32));
+
+        if(c32 == 0) {
+            continue;
+        }
+
+        // Replicate coverage values to all channels of their pixels.
+        __m128i c = _mm_cvtsi32_si128((int)c32);
+        c = _mm_unpacklo_epi8(c, c);
+        c = _mm_unpacklo_epi16(c, c);
+
+        // Load target pixels.
+        __m128i t = _mm_loadu_si128((__m128i const*)target);
+
+        // Compute and store resulting pixels.
+        __m128i lo = rose_composite_pixels_sse2(
+            color16, _mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(t, zero));
+
+        __m128i hi = rose_composite_pixels_sse2(
+            color16, _mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(t, zero));
+
+        _mm_storeu_si128((__m128i*)target, _mm_packus_epi16(lo, hi));
+    }
+
+    // Composite remaining pixels.
+    rose_composite_scalar(target, coverage + i, size - i, color);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2 kernel implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef ROSE_COMPOSITING_X86_64
+
+__attribute__((target("avx2"))) static inline __m256i
+rose_divide_by_255_avx2(__m256i x) {
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+__attribute__((target("avx2"))) static inline __m256i
+rose_composite_pixels_avx2(__m256i color, __m256i c, __m256i target) {
+    return _mm256_add_epi16(
+        rose_divide_by_255_avx2(_mm256_mullo_epi16(color, c)),
+        rose_divide_by_255_avx2(_mm256_mullo_epi16(
+            target, _mm256_sub_epi16(_mm256_set1_epi16(255), c))));
+}
+
+__attribute__((target("avx2"))) static void
+rose_composite_avx2(
+    unsigned char* target, unsigned char const* coverage, size_t size,
+    uint32_t color) {
+    // Expand color's channels to 16 bit lanes (two pixels per 128 bit lane).
+    __m256i const zero = _mm256_setzero_si256();
+    __m256i const color16 = _mm256_unpacklo_epi8(
+        _mm256_set1_epi32((int)(color | 0xFF000000u)), zero);
+
+    // Initialize a mask which replicates coverage values of eight pixels to all
+    // channels of these pixels.
+    __m256i const mask = _mm256_setr_epi8(
+        0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, //
+        4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+
+    // Composite eight pixels per iteration.
+    size_t i = 0;
+    for(; (i + 8) <= size; i += 8, target += 32) {
+        // Obtain coverage, skip fully transparent pixels.
+        uint64_t c64 = 0;
+        memcpy(&c64, coverage + i, sizeof(c64));
+
+        if(c64 == 0) {
+            continue;
+        }
+
+        // Replicate coverage values to all channels of their pixels.
+        __m256i c = _mm256_shuffle_epi8(
+            _mm256_set1_epi64x((long long)(c64)), mask);
+
+        // Load target pixels.
+        __m256i t = _mm256_loadu_si256((__m256i const*)target);
+
+        // Compute and store resulting pixels.
+        __m256i lo = rose_composite_pixels_avx2(
+            color16, _mm256_unpacklo_epi8(c, zero),
+            _mm256_unpacklo_epi8(t, zero));
+
+        __m256i hi = rose_composite_pixels_avx2(
+            color16, _mm256_unpackhi_epi8(c, zero),
+            _mm256_unpackhi_epi8(t, zero));
+
+        _mm256_storeu_si256((__m256i*)target, _mm256_packus_epi16(lo, hi));
+    }
+
+    // Composite remaining pixels.
+    // Note: Upper halves of YMM registers are cleared to avoid AVX-SSE
+    // transition penalties.
+    _mm256_zeroupper();
+    rose_composite_sse2(target, coverage + i, size - i, color);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernel selection interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+rose_compositing_kernel_fn
+rose_compositing_kernel_obtain(enum rose_compositing_kernel_type type) {
+    switch(type) {
+        case rose_compositing_kernel_type_scalar:
+            return rose_composite_scalar;
+
+#ifdef ROSE_COMPOSITING_X86_64
+        case rose_compositing_kernel_type_sse2:
+            // Note: SSE2 is always available on x86-64.
+            return rose_composite_sse2;
+
+        case rose_compositing_kernel_type_avx2:
+            return (__builtin_cpu_supports("avx2") ? rose_composite_avx2
+                                                   : NULL);
+#endif
+
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+rose_compositing_kernel_fn
+rose_compositing_kernel_select(void) {
+    // Select the first supported kernel, starting from the fastest one.
+    for(ptrdiff_t i = rose_compositing_kernel_type_count_ - 1; i >= 0; --i) {
+        rose_compositing_kernel_fn kernel = rose_compositing_kernel_obtain(
+            (enum rose_compositing_kernel_type)(i));
+
+        if(kernel != NULL) {
+            return kernel;
+        }
+    }
+
+    return rose_composite_scalar;
+}
@@ -0,0 +1,49 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_C196273DB659446892F0A6B2E8DA0CD5
+#define H_C196273DB659446892F0A6B2E8DA0CD5
+
+#include <stddef.h>
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Compositing kernel type definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_compositing_kernel_type {
+    rose_compositing_kernel_type_scalar,
+    rose_compositing_kernel_type_sse2,
+    rose_compositing_kernel_type_avx2,
+    rose_compositing_kernel_type_count_
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Compositing kernel definition.
+//
+// Note: A kernel colors the given row of 8 bit coverage values with the given
+// color (specified in ARGB8888 format, color's alpha is ignored), and
+// composites the result over the given row of premultiplied ARGB8888 pixels
+// using "over" operator. All kernels produce identical results.
+////////////////////////////////////////////////////////////////////////////////
+
+typedef void (*rose_compositing_kernel_fn)(
+    unsigned char* target, unsigned char const* coverage, size_t size,
+    uint32_t color);
+
+////////////////////////////////////////////////////////////////////////////////
+// Kernel selection interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Returns a kernel of the given type, or NULL if the kernel is not supported by
+// the CPU.
+rose_compositing_kernel_fn
+rose_compositing_kernel_obtain(enum rose_compositing_kernel_type type);
+
+// Returns the fastest kernel which is supported by the CPU.
+rose_compositing_kernel_fn
+rose_compositing_kernel_select(void);
+
+#endif // H_C196273DB659446892F0A6B2E8DA0CD5
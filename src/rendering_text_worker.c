@@ -0,0 +1,408 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "rendering_text.h"
+#include "rendering_text_worker.h"
+#include "trace.h"
+
+#include <wayland-server-core.h>
+
+#include <sys/eventfd.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Helper macros.
+////////////////////////////////////////////////////////////////////////////////
+
+#define unused_(x) ((void)(x))
+
+////////////////////////////////////////////////////////////////////////////////
+// Job definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_text_rendering_job {
+    // Glyphs which must be rendered.
+    struct rose_glyph_set* set;
+
+    // Completion handler and its data.
+    rose_text_rendering_job_completion_fn completion_fn;
+    void* data;
+
+    // Flag: indicates that the job has been cancelled.
+    bool is_cancelled;
+
+    // List link.
+    struct wl_list link;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Text rendering worker definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_text_rendering_worker_thread {
+    // Parent worker.
+    struct rose_text_rendering_worker* worker;
+
+    // Thread's text rendering context.
+    struct rose_text_rendering_context* context;
+
+    // Underlying thread.
+    pthread_t thread;
+    bool is_started;
+};
+
+struct rose_text_rendering_worker {
+    // Context which receives rendered glyphs.
+    struct rose_text_rendering_context* target_context;
+
+    // Event file descriptor, signalled when jobs are finished, and its event
+    // source.
+    int event_fd;
+    struct wl_event_source* event_source;
+
+    // Synchronization primitives which protect the lists of jobs and the flag.
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+
+    // Lists of pending, active, and finished jobs.
+    struct wl_list jobs_pending, jobs_active, jobs_finished;
+
+    // Flag: indicates that worker's threads must terminate.
+    bool is_terminating;
+
+    // Worker's threads.
+    size_t thread_count;
+    struct rose_text_rendering_worker_thread threads[];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Job destruction utility function.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_text_rendering_job_destroy(struct rose_text_rendering_job* job) {
+    rose_glyph_set_destroy(job->set);
+    wl_list_remove(&(job->link));
+
+    free(job);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Thread's entry point.
+////////////////////////////////////////////////////////////////////////////////
+
+static void*
+rose_text_rendering_worker_thread_run(void* data) {
+    // Obtain the thread and its worker.
+    struct rose_text_rendering_worker_thread* thread = data;
+    struct rose_text_rendering_worker* worker = thread->worker;
+
+    // Process the jobs.
+    pthread_mutex_lock(&(worker->mutex));
+    while(true) {
+        // Wait for a job.
+        while(!(worker->is_terminating) &&
+              wl_list_empty(&(worker->jobs_pending))) {
+            pthread_cond_wait(&(worker->condition), &(worker->mutex));
+        }
+
+        // Stop processing if the worker is terminating.
+        if(worker->is_terminating) {
+            break;
+        }
+
+        // Obtain the first pending job, mark it as active.
+        struct rose_text_rendering_job* job =
+            wl_container_of(worker->jobs_pending.next, job, link);
+
+        wl_list_remove(&(job->link));
+        wl_list_insert(worker->jobs_active.prev, &(job->link));
+
+        // Render job's glyphs without holding the lock.
+        // Note: Cancelled jobs are not rendered.
+        if(!(job->is_cancelled)) {
+            pthread_mutex_unlock(&(worker->mutex));
+
+            rose_trace_begin("glyph_set_render");
+            rose_glyph_set_render(thread->context, job->set);
+            rose_trace_end("glyph_set_render");
+
+            pthread_mutex_lock(&(worker->mutex));
+        }
+
+        // Mark the job as finished.
+        wl_list_remove(&(job->link));
+        wl_list_insert(worker->jobs_finished.prev, &(job->link));
+
+        // And notify event loop's thread.
+        // Note: Writing fails only if the counter overflows, in which case
+        // event loop's thread has not been notified of the previous jobs yet.
+        if(true) {
+            uint64_t value = 1;
+            ssize_t result = write(worker->event_fd, &value, sizeof(value));
+            unused_(result);
+        }
+    }
+
+    pthread_mutex_unlock(&(worker->mutex));
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Event handler: job completion.
+////////////////////////////////////////////////////////////////////////////////
+
+static int
+rose_handle_event_text_rendering_worker_job_completion(
+    int fd, uint32_t mask, void* data) {
+    unused_(mask);
+
+    // Obtain the worker.
+    struct rose_text_rendering_worker* worker = data;
+
+    // Reset the event file descriptor.
+    // Note: Reading can fail only if the counter is zero, in which case there
+    // is nothing to process.
+    if(true) {
+        uint64_t value = 0;
+        ssize_t result = read(fd, &value, sizeof(value));
+        unused_(result);
+    }
+
+    // Process finished jobs one-by-one.
+    // Note: Completion handlers might cancel other finished jobs, so each job
+    // is removed from the list of finished jobs only when it is processed.
+    while(true) {
+        // Obtain the first finished job.
+        struct rose_text_rendering_job* job = NULL;
+
+        pthread_mutex_lock(&(worker->mutex));
+        if(!wl_list_empty(&(worker->jobs_finished))) {
+            job = wl_container_of(worker->jobs_finished.next, job, link);
+
+            wl_list_remove(&(job->link));
+            wl_list_init(&(job->link));
+        }
+
+        pthread_mutex_unlock(&(worker->mutex));
+
+        // Stop processing if there are no more jobs.
+        if(job == NULL) {
+            break;
+        }
+
+        // Add rendered glyphs to the target context, and notify job's owner.
+        // Note: Cancelled jobs are skipped.
+        if(!(job->is_cancelled)) {
+            rose_glyph_set_insert(worker->target_context, job->set);
+            job->completion_fn(job->data);
+        }
+
+        // Destroy the job.
+        rose_text_rendering_job_destroy(job);
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization/destruction interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_text_rendering_worker*
+rose_text_rendering_worker_initialize(
+    struct rose_text_rendering_worker_parameters parameters) {
+    // Allocate memory for a new worker.
+    struct rose_text_rendering_worker* worker = malloc(
+        sizeof(struct rose_text_rendering_worker) +
+        sizeof(struct rose_text_rendering_worker_thread) *
+            parameters.context_count);
+
+    if(worker == NULL) {
+        for(size_t i = 0; i != parameters.context_count; ++i) {
+            rose_text_rendering_context_destroy(parameters.contexts[i]);
+        }
+
+        return NULL;
+    }
+
+    // Initialize the worker.
+    *worker = (struct rose_text_rendering_worker){
+        .target_context = parameters.target_context,
+        .event_fd = -1,
+        .thread_count = parameters.context_count};
+
+    for(size_t i = 0; i != parameters.context_count; ++i) {
+        worker->threads[i] = (struct rose_text_rendering_worker_thread){
+            .worker = worker, .context = parameters.contexts[i]};
+    }
+
+    wl_list_init(&(worker->jobs_pending));
+    wl_list_init(&(worker->jobs_active));
+    wl_list_init(&(worker->jobs_finished));
+
+    pthread_mutex_init(&(worker->mutex), NULL);
+    pthread_cond_init(&(worker->condition), NULL);
+
+    // The worker must have at least one thread.
+    if(worker->thread_count == 0) {
+        return (rose_text_rendering_worker_destroy(worker), NULL);
+    }
+
+    // Initialize event file descriptor and its event source.
+    worker->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(worker->event_fd == -1) {
+        return (rose_text_rendering_worker_destroy(worker), NULL);
+    }
+
+    worker->event_source = wl_event_loop_add_fd(
+        parameters.event_loop, worker->event_fd, WL_EVENT_READABLE,
+        rose_handle_event_text_rendering_worker_job_completion, worker);
+
+    if(worker->event_source == NULL) {
+        return (rose_text_rendering_worker_destroy(worker), NULL);
+    }
+
+    // Start the threads.
+    for(size_t i = 0; i != worker->thread_count; ++i) {
+        struct rose_text_rendering_worker_thread* thread =
+            &(worker->threads[i]);
+
+        thread->is_started =
+            (pthread_create(
+                 &(thread->thread), NULL, rose_text_rendering_worker_thread_run,
+                 thread) == 0);
+
+        if(!(thread->is_started)) {
+            return (rose_text_rendering_worker_destroy(worker), NULL);
+        }
+    }
+
+    return worker;
+}
+
+void
+rose_text_rendering_worker_destroy(struct rose_text_rendering_worker* worker) {
+    if(worker == NULL) {
+        return;
+    }
+
+    // Stop the threads.
+    pthread_mutex_lock(&(worker->mutex));
+    worker->is_terminating = true;
+    pthread_cond_broadcast(&(worker->condition));
+    pthread_mutex_unlock(&(worker->mutex));
+
+    for(size_t i = 0; i != worker->thread_count; ++i) {
+        if(worker->threads[i].is_started) {
+            pthread_join(worker->threads[i].thread, NULL);
+        }
+    }
+
+    // Destroy all jobs.
+    if(true) {
+        struct wl_list* lists[] = {
+            &(worker->jobs_pending), &(worker->jobs_active),
+            &(worker->jobs_finished)};
+
+        for(size_t i = 0; i != (sizeof(lists) / sizeof(lists[0])); ++i) {
+            struct rose_text_rendering_job* job = NULL;
+            struct rose_text_rendering_job* _ = NULL;
+
+            wl_list_for_each_safe(job, _, lists[i], link) {
+                rose_text_rendering_job_destroy(job);
+            }
+        }
+    }
+
+    // Remove event source and close event file descriptor.
+    if(worker->event_source != NULL) {
+        wl_event_source_remove(worker->event_source);
+    }
+
+    if(worker->event_fd != -1) {
+        close(worker->event_fd);
+    }
+
+    // Destroy synchronization primitives.
+    pthread_cond_destroy(&(worker->condition));
+    pthread_mutex_destroy(&(worker->mutex));
+
+    // Destroy threads' contexts.
+    for(size_t i = 0; i != worker->thread_count; ++i) {
+        rose_text_rendering_context_destroy(worker->threads[i].context);
+    }
+
+    // Free memory.
+    free(worker);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Job manipulation interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+bool
+rose_text_rendering_worker_submit(
+    struct rose_text_rendering_worker* worker, struct rose_glyph_set* set,
+    rose_text_rendering_job_completion_fn completion_fn, void* data) {
+    // Allocate and initialize a new job.
+    struct rose_text_rendering_job* job =
+        malloc(sizeof(struct rose_text_rendering_job));
+
+    if(job == NULL) {
+        return (rose_glyph_set_destroy(set), false);
+    }
+
+    *job = (struct rose_text_rendering_job){
+        .set = set, .completion_fn = completion_fn, .data = data};
+
+    // Add the job to the list of pending jobs, and wake up a thread.
+    pthread_mutex_lock(&(worker->mutex));
+    wl_list_insert(worker->jobs_pending.prev, &(job->link));
+    pthread_cond_signal(&(worker->condition));
+    pthread_mutex_unlock(&(worker->mutex));
+
+    return true;
+}
+
+void
+rose_text_rendering_worker_cancel(
+    struct rose_text_rendering_worker* worker, void* data) {
+    pthread_mutex_lock(&(worker->mutex));
+
+    // Remove pending jobs.
+    if(true) {
+        struct rose_text_rendering_job* job = NULL;
+        struct rose_text_rendering_job* _ = NULL;
+
+        wl_list_for_each_safe(job, _, &(worker->jobs_pending), link) {
+            if(job->data == data) {
+                rose_text_rendering_job_destroy(job);
+            }
+        }
+    }
+
+    // Mark active and finished jobs as cancelled.
+    // Note: Such jobs are destroyed when they are finished.
+    if(true) {
+        struct wl_list* lists[] = {
+            &(worker->jobs_active), &(worker->jobs_finished)};
+
+        for(size_t i = 0; i != (sizeof(lists) / sizeof(lists[0])); ++i) {
+            struct rose_text_rendering_job* job = NULL;
+            wl_list_for_each(job, lists[i], link) {
+                if(job->data == data) {
+                    job->is_cancelled = true;
+                }
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&(worker->mutex));
+}
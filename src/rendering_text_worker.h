@@ -0,0 +1,88 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_8E1F6B2D94C04A7FB35D0C6E2A71F948
+#define H_8E1F6B2D94C04A7FB35D0C6E2A71F948
+
+#include <stdbool.h>
+#include <stddef.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Forward declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+struct wl_event_loop;
+
+struct rose_text_rendering_context;
+struct rose_glyph_set;
+
+////////////////////////////////////////////////////////////////////////////////
+// Text rendering worker declaration.
+// Note: Pointer to this type shall be used as an opaque handle.
+//
+// Note: Text rendering worker renders glyphs in its own threads, each of which
+// uses its own text rendering context. Rendered glyphs are added to the glyph
+// cache of the target context in event loop's thread, after which job's
+// completion handler is called, so that text can be rendered from the cache
+// without calling FreeType.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_text_rendering_worker;
+
+////////////////////////////////////////////////////////////////////////////////
+// Job completion handler definition.
+////////////////////////////////////////////////////////////////////////////////
+
+typedef void (*rose_text_rendering_job_completion_fn)(void* data);
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization parameters definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct rose_text_rendering_worker_parameters {
+    // Event loop which receives rendered glyphs.
+    struct wl_event_loop* event_loop;
+
+    // Context which receives rendered glyphs, used only in event loop's thread.
+    struct rose_text_rendering_context* target_context;
+
+    // Contexts of worker's threads (one thread per context). Each context must
+    // be initialized with the same fonts as the target context.
+    struct rose_text_rendering_context** contexts;
+    size_t context_count;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Initialization/destruction interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: This function takes ownership of the contexts of worker's threads. If
+// this function fails, then these contexts are destroyed.
+struct rose_text_rendering_worker*
+rose_text_rendering_worker_initialize(
+    struct rose_text_rendering_worker_parameters parameters);
+
+void
+rose_text_rendering_worker_destroy(struct rose_text_rendering_worker* worker);
+
+////////////////////////////////////////////////////////////////////////////////
+// Job manipulation interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Submits a job which renders glyphs of the given set. Returns false on error.
+// Note: This function takes ownership of the set, the set is destroyed on
+// error.
+bool
+rose_text_rendering_worker_submit(
+    struct rose_text_rendering_worker* worker, struct rose_glyph_set* set,
+    rose_text_rendering_job_completion_fn completion_fn, void* data);
+
+// Cancels all jobs which have been submitted with the given data. Completion
+// handlers of such jobs are never called.
+void
+rose_text_rendering_worker_cancel(
+    struct rose_text_rendering_worker* worker, void* data);
+
+#endif // H_8E1F6B2D94C04A7FB35D0C6E2A71F948
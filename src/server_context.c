@@ -3,13 +3,17 @@
 // (See accompanying file LICENSE_GPL_3_0.txt or copy at
 // https://www.gnu.org/licenses/gpl-3.0.txt)
 //
+#include "benchmark.h"
 #include "filesystem.h"
+#include "rendering_text_worker.h"
 #include "server_context.h"
+#include "trace.h"
 
 #include <wlr/backend.h>
 #include <wlr/backend/libinput.h>
 
 #include <wlr/render/allocator.h>
+#include <wlr/render/pixman.h>
 #include <wlr/render/wlr_renderer.h>
 
 #include <wlr/types/wlr_compositor.h>
@@ -61,6 +65,15 @@
     for(type* x = array, *sentinel = array + array_size_(array); \
         x != sentinel; ++x)
 
+////////////////////////////////////////////////////////////////////////////////
+// Text rendering worker's parameters.
+//
+// Note: Each of worker's threads has its own text rendering context with its
+// own copy of the fonts, hence the number of threads is kept small.
+////////////////////////////////////////////////////////////////////////////////
+
+enum { rose_text_rendering_thread_count_max = 4 };
+
 ////////////////////////////////////////////////////////////////////////////////
 // String buffer definition.
 ////////////////////////////////////////////////////////////////////////////////
@@ -708,10 +721,12 @@ rose_server_context_initialize(struct rose_server_context* context) {
     }
 
     // Initialize text rendering context.
+    struct rose_utf8_string_buffer fonts_file_path = {};
     for_each_(struct rose_utf8_string, path, context->config.paths) {
+        fonts_file_path = rose_utf8_string_concat(path->data, "fonts");
         context->text_rendering_context =
             rose_text_rendering_context_initialize_from_file(
-                rose_utf8_string_concat(path->data, "fonts").data);
+                fonts_file_path.data);
 
         if(context->text_rendering_context != NULL) {
             break;
@@ -772,6 +787,57 @@ rose_server_context_initialize(struct rose_server_context* context) {
             context->event_loop, rose_handle_event_server_context_timer_expiry,
             context));
 
+    // Initialize text rendering worker with one thread per online processor,
+    // up to the limit.
+    // Note: Worker's text rendering contexts are initialized from the same file
+    // as the main one. The worker is optional: without it, glyphs are rendered
+    // synchronously.
+    if(true) {
+        // Compute the number of worker's threads.
+        long processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+        size_t thread_count =
+            ((processor_count < 1)
+                 ? 1
+                 : ((processor_count > rose_text_rendering_thread_count_max)
+                        ? rose_text_rendering_thread_count_max
+                        : (size_t)(processor_count)));
+
+        // Initialize text rendering contexts of the threads.
+        // Note: If some of the contexts can not be initialized, then the
+        // worker starts fewer threads.
+        struct rose_text_rendering_context*
+            contexts[rose_text_rendering_thread_count_max] = {};
+
+        size_t context_count = 0;
+        for(size_t i = 0; i != thread_count; ++i) {
+            contexts[context_count] =
+                rose_text_rendering_context_initialize_from_file(
+                    fonts_file_path.data);
+
+            if(contexts[context_count] != NULL) {
+                context_count++;
+            }
+        }
+
+        // Initialize the worker.
+        if(context_count != 0) {
+            context->text_rendering_worker =
+                rose_text_rendering_worker_initialize(
+                    (struct rose_text_rendering_worker_parameters){
+                        .event_loop = context->event_loop,
+                        .target_context = context->text_rendering_context,
+                        .contexts = contexts,
+                        .context_count = context_count});
+        }
+    }
+
+    // Initialize benchmark, if requested.
+    if(getenv("ROSE_BENCHMARK_REPORT") != NULL) {
+        try_(
+            context->benchmark =
+                rose_benchmark_initialize(getenv("ROSE_BENCHMARK_REPORT")));
+    }
+
     // Initialize cursor context.
     if(true) {
         // Create cursor manager.
@@ -867,6 +933,18 @@ rose_server_context_initialize(struct rose_server_context* context) {
         return false;
     }
 
+    // Enable software composition if the renderer is pixman-based, unless it
+    // has been explicitly disabled.
+    context->is_software_composition_enabled =
+        wlr_renderer_is_pixman(context->renderer) &&
+        ((getenv("ROSE_SOFTWARE_COMPOSITION") == NULL) ||
+         (strcmp(getenv("ROSE_SOFTWARE_COMPOSITION"), "0") != 0));
+
+    // Initialize the raster pool.
+    try_(
+        context->raster_pool = rose_raster_pool_initialize(
+            context->renderer, &(context->metrics)));
+
     // Initialize the allocator.
     try_(
         context->allocator =
@@ -1048,12 +1126,32 @@ rose_server_context_destroy(struct rose_server_context* context) {
         }
     }
 
+    // Destroy text rendering worker.
+    // Note: The worker is destroyed before the display, since it uses display's
+    // event loop.
+    if(context->text_rendering_worker != NULL) {
+        context->text_rendering_worker =
+            (rose_text_rendering_worker_destroy(context->text_rendering_worker),
+             NULL);
+    }
+
     // Destroy the display.
     if(context->display != NULL) {
         wl_display_destroy_clients(context->display);
         wl_display_destroy(context->display);
     }
 
+    // Destroy the benchmark. At this point all outputs have been destroyed, so
+    // no more frames can be recorded.
+    rose_benchmark_destroy(context->benchmark);
+
+    // Free memory of trace ring buffers. At this point text rendering worker's
+    // threads have been stopped, so no other threads record trace events.
+    rose_trace_finalize();
+
+    // Destroy the raster pool.
+    rose_raster_pool_destroy(context->raster_pool);
+
     // Destroy the renderer.
     if(context->renderer != NULL) {
         wlr_renderer_destroy(context->renderer);
@@ -1282,6 +1380,8 @@ rose_server_context_configure(
         }
 
         // Request redraw operation.
+        // Note: The theme defines the colors of all rendered elements, hence
+        // the entire area of each output is damaged.
         struct rose_output* output;
         wl_list_for_each(output, &(context->outputs), link) {
             if(output->focused_workspace != NULL) {
@@ -1310,6 +1410,8 @@ rose_server_context_configure(
             rose_workspace_make_current(context->current_workspace);
 
             // Request redraw operation.
+            // Note: Locking and unlocking the screen replaces all content of
+            // each output, hence its entire area is damaged.
             struct rose_output* output;
             wl_list_for_each(output, &(context->outputs), link) {
                 if(output->focused_workspace != NULL) {
@@ -1336,6 +1438,8 @@ rose_server_context_configure(
             rose_workspace_make_current(context->current_workspace);
 
             // Request redraw operation.
+            // Note: Locking and unlocking the screen replaces all content of
+            // each output, hence its entire area is damaged.
             struct rose_output* output;
             wl_list_for_each(output, &(context->outputs), link) {
                 if(output->focused_workspace != NULL) {
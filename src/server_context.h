@@ -14,6 +14,7 @@
 #include "keyboard_context.h"
 
 #include "ipc_server.h"
+#include "metrics.h"
 #include "rendering.h"
 #include "rendering_raster.h"
 #include "rendering_theme.h"
@@ -35,6 +36,9 @@ struct wlr_tablet_manager_v2;
 
 struct wlr_seat;
 
+struct rose_text_rendering_worker;
+struct rose_benchmark;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cursor image definition.
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,6 +56,7 @@ struct rose_cursor_image {
 struct rose_server_context {
     // Associated contexts.
     struct rose_text_rendering_context* text_rendering_context;
+    struct rose_text_rendering_worker* text_rendering_worker;
     struct rose_keyboard_context* keyboard_context;
 
     struct {
@@ -77,6 +82,14 @@ struct rose_server_context {
     struct wlr_renderer* renderer;
     struct wlr_allocator* allocator;
 
+    // A flag which shows that outputs' content is composed directly with
+    // pixman, bypassing renderer's render passes where possible.
+    // Note: This is only possible if the renderer is pixman-based.
+    bool is_software_composition_enabled;
+
+    // Pool of rasters which is shared by all outputs.
+    struct rose_raster_pool* raster_pool;
+
     // Wayland protocols.
     struct wlr_relative_pointer_manager_v1* relative_pointer_manager;
     struct wlr_pointer_constraints_v1* pointer_constraints;
@@ -136,6 +149,12 @@ struct rose_server_context {
     // Device preference list.
     struct rose_device_preference_list* preference_list;
 
+    // Benchmark, if requested.
+    struct rose_benchmark* benchmark;
+
+    // Performance metrics.
+    struct rose_metrics metrics;
+
     // Event listeners.
     struct wl_listener listener_backend_new_input;
     struct wl_listener listener_backend_new_output;
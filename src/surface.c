@@ -4,6 +4,7 @@
 // https://www.gnu.org/licenses/gpl-3.0.txt)
 //
 #include "server_context.h"
+#include "trace.h"
 
 #include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_subcompositor.h>
@@ -14,6 +15,7 @@
 
 #include <stddef.h>
 #include <stdlib.h>
+#include <time.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Helper macros.
@@ -416,6 +418,9 @@ rose_handle_event_surface_commit(struct wl_listener* listener, void* data) {
     struct rose_surface* surface =
         wl_container_of(listener, surface, listener_commit);
 
+    // Start tracing the commit.
+    rose_trace_begin("surface_commit");
+
     // Synchronize surface's state.
     rose_surface_state_sync(surface);
 
@@ -434,6 +439,30 @@ rose_handle_event_surface_commit(struct wl_listener* listener, void* data) {
         // Configure surface's decoration.
         rose_surface_set_decoration_mode(surface);
     } else if(surface->type == rose_surface_type_toplevel) {
+        // Measure the time it took the client to commit a new frame after the
+        // last frame done event.
+        //
+        // Note: Lead times longer than one refresh period do not fit before
+        // output's presentation deadline anyway, and are discarded, so that a
+        // single stall does not disable frame pacing.
+        if(surface->frame_pacing.frame_done_time != 0) {
+            struct timespec timestamp = {};
+            clock_gettime(CLOCK_MONOTONIC, &timestamp);
+
+            uint64_t time = (uint64_t)(timestamp.tv_sec) * 1000000000 +
+                            (uint64_t)(timestamp.tv_nsec);
+
+            if((time > surface->frame_pacing.frame_done_time) &&
+               ((time - surface->frame_pacing.frame_done_time) <=
+                surface->frame_pacing.refresh_period)) {
+                rose_output_frame_time_history_record(
+                    &(surface->frame_pacing.commit_times),
+                    time - surface->frame_pacing.frame_done_time);
+            }
+
+            surface->frame_pacing.frame_done_time = 0;
+        }
+
         // Commit surface's transaction, if needed.
         //
         // Note: A widget shall never have a running transaction.
@@ -471,6 +500,9 @@ rose_handle_event_surface_commit(struct wl_listener* listener, void* data) {
     } else {
         rose_output_ui_notify_surface_commit(master->parent.ui, surface);
     }
+
+    // Finish tracing the commit.
+    rose_trace_end("surface_commit");
 }
 
 static void
@@ -6,6 +6,7 @@
 #ifndef H_A76D639897FD4AFA9AE6F973C9700F38
 #define H_A76D639897FD4AFA9AE6F973C9700F38
 
+#include "device_output_frame_scheduler.h"
 #include "surface_snapshot.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -148,8 +149,29 @@ struct rose_surface {
     // Storage for surface's snapshots.
     struct rose_surface_snapshot snapshots[rose_surface_snapshot_type_count_];
 
+    // Frame pacing data.
+    // Note: Frame pacing is only performed for toplevel surfaces, frame done
+    // events are sent to their child entities at the same time.
+    struct {
+        // Recently measured durations between sending frame done events and
+        // receiving subsequent commits. These are the lead times which the
+        // client needs before output's presentation deadline.
+        struct rose_output_frame_time_history commit_times;
+
+        // Time when the last frame done event has been sent to a pending
+        // frame callback (zero if a commit has been received since then), the
+        // time when a delayed frame done event must be sent (zero if there is
+        // no such event), and output's refresh period at the moment of sending
+        // the last frame done event, in nanoseconds.
+        uint64_t frame_done_time, frame_done_deadline, refresh_period;
+    } frame_pacing;
+
     // Flags.
-    bool is_mapped, is_visible, is_name_updated, is_transaction_running;
+    // Note: Occlusion flag is only valid for visible surfaces of focused
+    // workspaces, and shows that the surface is fully covered by opaque
+    // surfaces and decorations above it. It is updated by the rendering pass.
+    bool is_mapped, is_visible, is_occluded, is_name_updated,
+        is_transaction_running;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
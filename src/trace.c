@@ -0,0 +1,275 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "trace.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Trace event definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum rose_trace_event_type {
+    rose_trace_event_type_begin,
+    rose_trace_event_type_end,
+    rose_trace_event_type_instant
+};
+
+struct rose_trace_event {
+    // Event's timestamp (in nanoseconds).
+    uint64_t time;
+
+    // Event's name and type.
+    char const* name;
+    enum rose_trace_event_type type;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Ring buffer definition.
+////////////////////////////////////////////////////////////////////////////////
+
+enum { rose_trace_ring_size = 1 << 16 };
+
+struct rose_trace_ring {
+    // Next ring buffer in the list.
+    struct rose_trace_ring* next;
+
+    // ID of the thread which owns this ring buffer.
+    unsigned thread_id;
+
+    // Total number of events which have been written to this ring buffer.
+    // Note: Only the owning thread writes events, other threads read them.
+    atomic_size_t head;
+
+    // Events.
+    struct rose_trace_event events[rose_trace_ring_size];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Tracing state definition.
+////////////////////////////////////////////////////////////////////////////////
+
+static struct {
+    // A flag which shows that tracing is active.
+    atomic_bool is_active;
+
+    // Time when tracing has been started (in nanoseconds).
+    _Atomic(uint64_t) start_time;
+
+    // List of all ring buffers, and the number of threads which own them.
+    _Atomic(struct rose_trace_ring*) rings;
+    atomic_uint thread_count;
+} rose_trace_state;
+
+// Current thread's ring buffer.
+static _Thread_local struct rose_trace_ring* rose_trace_thread_ring;
+
+// A flag which shows that current thread could not allocate its ring buffer.
+static _Thread_local bool rose_trace_thread_ring_is_unavailable;
+
+static char const* const rose_trace_event_phases[] = {
+    [rose_trace_event_type_begin] = "B",
+    [rose_trace_event_type_end] = "E",
+    [rose_trace_event_type_instant] = "i"};
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t
+rose_trace_obtain_time(void) {
+    struct timespec timestamp = {};
+    clock_gettime(CLOCK_MONOTONIC, &timestamp);
+
+    return (uint64_t)(timestamp.tv_sec) * 1000000000 +
+           (uint64_t)(timestamp.tv_nsec);
+}
+
+static struct rose_trace_ring*
+rose_trace_ring_obtain(void) {
+    // Return current thread's ring buffer, if it has already been allocated.
+    if((rose_trace_thread_ring != NULL) ||
+       rose_trace_thread_ring_is_unavailable) {
+        return rose_trace_thread_ring;
+    }
+
+    // Otherwise, allocate a new ring buffer.
+    struct rose_trace_ring* ring = malloc(sizeof(struct rose_trace_ring));
+    if(ring == NULL) {
+        return (rose_trace_thread_ring_is_unavailable = true), NULL;
+    }
+
+    // Initialize it.
+    ring->thread_id = atomic_fetch_add(&(rose_trace_state.thread_count), 1);
+    atomic_init(&(ring->head), 0);
+
+    // Add it to the list.
+    ring->next = atomic_load(&(rose_trace_state.rings));
+    while(!atomic_compare_exchange_weak(
+        &(rose_trace_state.rings), &(ring->next), ring)) {
+    }
+
+    // And make it current thread's ring buffer.
+    return (rose_trace_thread_ring = ring);
+}
+
+static void
+rose_trace_record(enum rose_trace_event_type type, char const* name) {
+    // Do nothing if tracing is not active.
+    if(!atomic_load_explicit(
+           &(rose_trace_state.is_active), memory_order_relaxed)) {
+        return;
+    }
+
+    // Obtain current thread's ring buffer.
+    struct rose_trace_ring* ring = rose_trace_ring_obtain();
+    if(ring == NULL) {
+        return;
+    }
+
+    // Write the event.
+    size_t head = atomic_load_explicit(&(ring->head), memory_order_relaxed);
+    ring->events[head % rose_trace_ring_size] = (struct rose_trace_event){
+        .time = rose_trace_obtain_time(), .name = name, .type = type};
+
+    // And publish it.
+    atomic_store_explicit(&(ring->head), head + 1, memory_order_release);
+}
+
+static bool
+rose_trace_ring_write(
+    struct rose_trace_ring* ring, uint64_t start_time, bool is_first,
+    FILE* file) {
+    // Obtain the range of events which can be read.
+    size_t head = atomic_load_explicit(&(ring->head), memory_order_acquire);
+    size_t i =
+        ((head > rose_trace_ring_size) ? (head - rose_trace_ring_size) : 0);
+
+    // Obtain process's ID.
+    int pid = (int)(getpid());
+
+    // Write the events.
+    for(; i != head; ++i) {
+        // Read the event.
+        struct rose_trace_event event = ring->events[i % rose_trace_ring_size];
+
+        // Skip the event if it has been overwritten while it was being read.
+        // Note: Events can only be overwritten by the thread which still
+        // records them. The writer overwrites event's slot while the head is
+        // exactly one ring size ahead of the event, before publishing the next
+        // head, so such an event might be torn and is skipped as well.
+        atomic_thread_fence(memory_order_acquire);
+        if((atomic_load_explicit(&(ring->head), memory_order_relaxed) - i) >=
+           rose_trace_ring_size) {
+            continue;
+        }
+
+        // Skip the event if it has been recorded before tracing has started.
+        if(event.time < start_time) {
+            continue;
+        }
+
+        // Write the event.
+        fprintf(
+            file,
+            "%s{\"name\": \"%s\", \"ph\": \"%s\", \"ts\": %.3f, \"pid\": %d, "
+            "\"tid\": %u%s}",
+            (is_first ? "\n" : ",\n"), event.name,
+            rose_trace_event_phases[event.type],
+            (double)(event.time - start_time) / 1000.0, pid, ring->thread_id,
+            ((event.type == rose_trace_event_type_instant) ? ", \"s\": \"t\""
+                                                           : ""));
+
+        is_first = false;
+    }
+
+    return is_first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tracing state manipulation interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_trace_start(void) {
+    atomic_store(&(rose_trace_state.start_time), rose_trace_obtain_time());
+    atomic_store(&(rose_trace_state.is_active), true);
+}
+
+bool
+rose_trace_stop(char const* file_path) {
+    // Stop tracing.
+    atomic_store(&(rose_trace_state.is_active), false);
+
+    // Open the file.
+    FILE* file = fopen(file_path, "w");
+    if(file == NULL) {
+        return false;
+    }
+
+    // Write recorded events of all threads.
+    uint64_t start_time = atomic_load(&(rose_trace_state.start_time));
+    bool is_first = true;
+
+    fprintf(file, "{\"traceEvents\": [");
+    for(struct rose_trace_ring* ring = atomic_load(&(rose_trace_state.rings));
+        ring != NULL; ring = ring->next) {
+        is_first = rose_trace_ring_write(ring, start_time, is_first, file);
+    }
+
+    fprintf(file, "\n],\n\"displayTimeUnit\": \"ms\"}\n");
+
+    // Close the file.
+    bool is_written = (ferror(file) == 0);
+    return (fclose(file) == 0) && is_written;
+}
+
+void
+rose_trace_finalize(void) {
+    // Stop tracing.
+    atomic_store(&(rose_trace_state.is_active), false);
+
+    // Free memory of all ring buffers.
+    struct rose_trace_ring* ring =
+        atomic_exchange(&(rose_trace_state.rings), NULL);
+
+    while(ring != NULL) {
+        struct rose_trace_ring* next = ring->next;
+        free(ring), ring = next;
+    }
+
+    // Reset current thread's state.
+    rose_trace_thread_ring = NULL;
+}
+
+bool
+rose_trace_is_active(void) {
+    return atomic_load(&(rose_trace_state.is_active));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Recording interface implementation.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_trace_begin(char const* name) {
+    rose_trace_record(rose_trace_event_type_begin, name);
+}
+
+void
+rose_trace_end(char const* name) {
+    rose_trace_record(rose_trace_event_type_end, name);
+}
+
+void
+rose_trace_instant(char const* name) {
+    rose_trace_record(rose_trace_event_type_instant, name);
+}
@@ -0,0 +1,64 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_4C2E9A7F1B6D48E3A05F3D9C8B7E2A16
+#define H_4C2E9A7F1B6D48E3A05F3D9C8B7E2A16
+
+#include <stdbool.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Tracing.
+//
+// Note: Each thread records its trace events to its own ring buffer, without
+// locking. A ring buffer is allocated when its thread records its first event
+// while tracing is active. When the ring buffer is full, the oldest events are
+// overwritten.
+//
+// Note: Tracing state is global, since trace events are recorded from the
+// threads which have no access to the server context.
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+// Tracing state manipulation interface.
+////////////////////////////////////////////////////////////////////////////////
+
+// Starts tracing. Events which have been recorded before this call are
+// discarded.
+void
+rose_trace_start(void);
+
+// Stops tracing and writes recorded events to the file with the given path, in
+// Chrome's trace event format (which is also supported by Perfetto). Returns
+// false on error.
+bool
+rose_trace_stop(char const* file_path);
+
+// Frees memory of all ring buffers.
+// Note: This function must only be called when no other threads record trace
+// events.
+void
+rose_trace_finalize(void);
+
+bool
+rose_trace_is_active(void);
+
+////////////////////////////////////////////////////////////////////////////////
+// Recording interface.
+//
+// Note: Event names must be string literals which contain only characters that
+// do not need escaping in JSON strings. Begin/end events must be properly
+// nested within their threads.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+rose_trace_begin(char const* name);
+
+void
+rose_trace_end(char const* name);
+
+void
+rose_trace_instant(char const* name);
+
+#endif // H_4C2E9A7F1B6D48E3A05F3D9C8B7E2A16
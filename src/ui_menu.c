@@ -689,6 +689,9 @@ rose_ui_menu_hide(struct rose_ui_menu* menu) {
         return;
     }
 
+    // Damage menu's area.
+    rose_ui_menu_request_redraw(menu);
+
     // Remove the menu from the list of visible menus.
     wl_list_remove(&(menu->link));
     wl_list_init(&(menu->link));
@@ -699,9 +702,6 @@ rose_ui_menu_hide(struct rose_ui_menu* menu) {
     // Clear the menu.
     menu->head = menu->selection = (struct rose_ui_menu_line){};
     menu->page = (struct rose_ui_menu_page){};
-
-    // Request parent output's redraw.
-    rose_output_request_redraw(menu->output);
 }
 
 void
@@ -729,6 +729,9 @@ rose_ui_menu_update(struct rose_ui_menu* menu) {
     // Mark the menu as updated.
     menu->is_updated = true;
 
+    // Damage menu's previous area.
+    rose_ui_menu_request_redraw(menu);
+
     // Compute menu's layout.
     rose_ui_menu_layout_compute(menu);
 
@@ -738,8 +741,8 @@ rose_ui_menu_update(struct rose_ui_menu* menu) {
         rose_ui_menu_refresh(menu, skip);
     }
 
-    // Request parent output's redraw.
-    rose_output_request_redraw(menu->output);
+    // Damage menu's current area.
+    rose_ui_menu_request_redraw(menu);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
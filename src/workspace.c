@@ -4,6 +4,7 @@
 // https://www.gnu.org/licenses/gpl-3.0.txt)
 //
 #include "server_context.h"
+#include "trace.h"
 
 #include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_subcompositor.h>
@@ -58,6 +59,63 @@ rose_workspace_compute_main_area(struct rose_workspace* workspace) {
     return area;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Damage-related utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool
+rose_workspace_is_displayed(struct rose_workspace* workspace) {
+    return (workspace->output != NULL) &&
+           (workspace->output->focused_workspace == workspace);
+}
+
+static void
+rose_workspace_add_surface_damage(
+    struct rose_workspace* workspace, struct rose_surface* surface) {
+    if(rose_workspace_is_displayed(workspace)) {
+        rose_output_add_surface_extent_damage(workspace->output, surface);
+    }
+}
+
+static void
+rose_workspace_add_panel_damage(
+    struct rose_workspace* workspace, struct rose_ui_panel panel) {
+    // Do nothing if the workspace is not displayed.
+    if(!rose_workspace_is_displayed(workspace)) {
+        return;
+    }
+
+    // Compute panel's area.
+    // Note: The area is damaged regardless of panel's visibility, since it is
+    // used when the panel is shown or hidden.
+    struct rose_output_damage damage = {
+        .width = workspace->width, .height = workspace->height};
+
+    switch(panel.position) {
+        case rose_ui_panel_position_bottom:
+            damage.y = workspace->height - panel.size;
+            // fall-through
+
+        case rose_ui_panel_position_top:
+            damage.height = panel.size;
+            break;
+
+        case rose_ui_panel_position_right:
+            damage.x = workspace->width - panel.size;
+            // fall-through
+
+        case rose_ui_panel_position_left:
+            damage.width = panel.size;
+            break;
+
+        default:
+            break;
+    }
+
+    // Add the damage.
+    rose_output_add_damage(workspace->output, damage);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Surface selecting utility function.
 ////////////////////////////////////////////////////////////////////////////////
@@ -122,8 +180,12 @@ rose_workspace_layout_compute(struct rose_workspace* workspace) {
     surface = workspace->focused_surface;
 
     // If there is a focused surface, and it is mapped, then move it to the top
-    // of the list of mapped surfaces.
+    // of the list of mapped surfaces. Damage its area if it is raised.
     if((surface != NULL) && (surface->is_mapped)) {
+        if(workspace->surfaces_mapped.next != &(surface->link_mapped)) {
+            rose_workspace_add_surface_damage(workspace, surface);
+        }
+
         wl_list_remove(&(surface->link_mapped));
         wl_list_insert(&(workspace->surfaces_mapped), &(surface->link_mapped));
     }
@@ -163,19 +225,31 @@ rose_workspace_layout_compute(struct rose_workspace* workspace) {
     }
 
     // Clear the list of visible surfaces.
+    // Note: Visibility flags are kept, so that the surfaces which change their
+    // visibility can be damaged.
     wl_list_for_each_safe(
         surface, _, &(workspace->surfaces_visible), link_visible) {
-        // Reset surface's visibility flag.
-        surface->is_visible = false;
-
-        // Remove it from the list of visible surfaces.
+        // Remove the surface from the list of visible surfaces.
         wl_list_remove(&(surface->link_visible));
         wl_list_init(&(surface->link_visible));
     }
 
     // Build a new list of visible surfaces: iterate through the list of mapped
     // surfaces again.
+    bool is_covered = false;
     wl_list_for_each(surface, &(workspace->surfaces_mapped), link_mapped) {
+        // Damage the surface if its visibility changes.
+        if(surface->is_visible == is_covered) {
+            rose_workspace_add_surface_damage(workspace, surface);
+        }
+
+        // If the surface is covered by a maximized or fullscreen surface, then
+        // it is not visible.
+        if(is_covered) {
+            surface->is_visible = false;
+            continue;
+        }
+
         // Set surface's visibility flag.
         surface->is_visible = true;
 
@@ -184,16 +258,13 @@ rose_workspace_layout_compute(struct rose_workspace* workspace) {
         wl_list_insert(
             &(workspace->surfaces_visible), &(surface->link_visible));
 
-        // If the surface is maximized or in fullscreen mode, then break out of
-        // the cycle.
+        // If the surface is maximized or in fullscreen mode, then it covers all
+        // the surfaces below.
         if(surface->state.pending.is_maximized ||
            surface->state.pending.is_fullscreen) {
-            break;
+            is_covered = true;
         }
     }
-
-    // Request workspace's redraw.
-    rose_workspace_request_redraw(workspace);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -294,8 +365,12 @@ rose_workspace_layout_update(
         wl_list_remove(&(surface->link_mapped));
         wl_list_init(&(surface->link_mapped));
 
-        // Clear its visibility flag and remove it from the list of visible
-        // surfaces.
+        // Damage its area, clear its visibility flag, and remove it from the
+        // list of visible surfaces.
+        if(surface->is_visible) {
+            rose_workspace_add_surface_damage(workspace, surface);
+        }
+
         surface->is_visible = false;
 
         wl_list_remove(&(surface->link_visible));
@@ -620,10 +695,24 @@ apply:
                 workspace->focused_surface->pointer_constraint);
         }
 
-        // Cancel any interactive mode.
+        // Cancel any interactive mode. If the mode shows a resizing rectangle
+        // around the focused surface, then redraw the workspace, since the
+        // rectangle's area depends on pointer's movement.
+        if((workspace->mode != rose_workspace_mode_normal) &&
+           (workspace->mode != rose_workspace_mode_interactive_move)) {
+            rose_workspace_request_redraw(workspace);
+        }
+
         rose_workspace_cancel_interactive_mode(workspace);
     }
 
+    // Damage the panel which shows focused surface's title.
+    // Note: Surfaces themselves are not damaged, since their decorations do
+    // not depend on the focus.
+    if(workspace->focused_surface != surface) {
+        rose_workspace_add_panel_damage(workspace, workspace->panel);
+    }
+
     // Focus the surface (or reset the focus if there is no surface).
     workspace->focused_surface = surface;
 
@@ -962,7 +1051,10 @@ rose_workspace_reposition_surface(
 void
 rose_workspace_set_panel(
     struct rose_workspace* workspace, struct rose_ui_panel panel) {
-    // Update the panel.
+    // Update the panel, and damage its previous and current areas.
+    rose_workspace_add_panel_damage(workspace, workspace->panel);
+    rose_workspace_add_panel_damage(workspace, panel);
+
     workspace->panel_saved = workspace->panel;
     workspace->panel = panel;
 
@@ -1149,6 +1241,9 @@ rose_workspace_notify_output_mode(
     // Recompute workspace's layout.
     rose_workspace_layout_compute(workspace);
 
+    // Request workspace's redraw, since its entire area has changed.
+    rose_workspace_request_redraw(workspace);
+
     // Update pointer's position, if needed.
     if((workspace->pointer.x > workspace->width) ||
        (workspace->pointer.y > workspace->height)) {
@@ -1187,9 +1282,9 @@ rose_workspace_notify_surface_name_update(
         }
     }
 
-    // Request workspace's redraw, if needed.
+    // Damage the panel which shows focused surface's title, if needed.
     if(workspace->focused_surface == surface) {
-        rose_workspace_request_redraw(workspace);
+        rose_workspace_add_panel_damage(workspace, workspace->panel);
     }
 }
 
@@ -1327,6 +1422,13 @@ rose_workspace_transaction_start(struct rose_workspace* workspace) {
     // Set the starting time of the transaction.
     clock_gettime(CLOCK_MONOTONIC, &(workspace->transaction.start_time));
 
+    // Register transaction's start in the metrics.
+    rose_metrics_transaction_start(
+        &(workspace->context->metrics), &(workspace->transaction.is_running));
+
+    // Trace the event.
+    rose_trace_instant("transaction_start");
+
     // A flag which shows that the panel is currently hidden, even if it has its
     // visibility flag set.
     bool is_panel_hidden = false;
@@ -1366,6 +1468,31 @@ rose_workspace_transaction_update(struct rose_workspace* workspace) {
 
 void
 rose_workspace_transaction_commit(struct rose_workspace* workspace) {
+    // Register transaction's end in the metrics and in the trace.
+    // Note: Normally the sentinel is already zero at this point, hence the
+    // metrics and the trace are updated based on transaction's own flag.
+    if(true) {
+        // Compute transaction's duration.
+        struct timespec timestamp = {};
+        clock_gettime(CLOCK_MONOTONIC, &timestamp);
+
+        int64_t duration =
+            (int64_t)(timestamp.tv_sec -
+                      workspace->transaction.start_time.tv_sec) *
+                1000000000 +
+            (int64_t)(timestamp.tv_nsec -
+                      workspace->transaction.start_time.tv_nsec);
+
+        // Update the metrics, and trace the event, if the transaction has
+        // been started.
+        if(rose_metrics_transaction_finish(
+               &(workspace->context->metrics),
+               &(workspace->transaction.is_running),
+               (uint64_t)((duration > 0) ? duration : 0))) {
+            rose_trace_instant("transaction_commit");
+        }
+    }
+
     // Reset transaction's state.
     workspace->transaction.sentinel = 0;
 
@@ -89,6 +89,10 @@ struct rose_workspace {
         // Transaction's starting time.
         struct timespec start_time;
 
+        // A flag which shows that transaction's start has been registered in
+        // the metrics.
+        bool is_running;
+
         // Transaction's watchdog timer.
         struct wl_event_source* timer;
     } transaction;
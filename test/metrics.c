@@ -0,0 +1,92 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "metrics.h"
+#include "test.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility macros.
+////////////////////////////////////////////////////////////////////////////////
+
+#define transaction_count_(metrics) \
+    ((metrics).counters[rose_metrics_counter_type_transactions])
+
+#define running_transaction_count_(metrics) \
+    ((metrics).gauges[rose_metrics_gauge_type_transactions])
+
+#define transaction_duration_count_(metrics)                           \
+    ((metrics)                                                         \
+         .histograms[rose_metrics_histogram_type_transaction_duration] \
+         .count)
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_test_transaction_completion(void) {
+    struct rose_metrics metrics = {};
+    bool is_running = false;
+
+    // A transaction which completes normally must be counted, and must not be
+    // considered running afterwards.
+    // Note: This mirrors the workspace, where the sentinel is decremented to
+    // zero before the transaction is committed.
+    rose_metrics_transaction_start(&metrics, &is_running);
+    check_(is_running);
+    check_(running_transaction_count_(metrics) == 1);
+
+    check_(rose_metrics_transaction_finish(&metrics, &is_running, 5000000));
+    check_(!is_running);
+    check_(transaction_count_(metrics) == 1);
+    check_(running_transaction_count_(metrics) == 0);
+    check_(transaction_duration_count_(metrics) == 1);
+
+    // Forced commit after the transaction has already finished must not be
+    // counted.
+    check_(!rose_metrics_transaction_finish(&metrics, &is_running, 0));
+    check_(transaction_count_(metrics) == 1);
+    check_(running_transaction_count_(metrics) == 0);
+    check_(transaction_duration_count_(metrics) == 1);
+}
+
+static void
+rose_test_transaction_restart(void) {
+    struct rose_metrics metrics = {};
+    bool is_running = false;
+
+    // Repeated starts of a running transaction must be registered once.
+    rose_metrics_transaction_start(&metrics, &is_running);
+    rose_metrics_transaction_start(&metrics, &is_running);
+    check_(running_transaction_count_(metrics) == 1);
+
+    // The number of running transactions must stay balanced over many
+    // transactions.
+    for(int i = 0; i != 100; ++i) {
+        rose_metrics_transaction_finish(&metrics, &is_running, 1000000);
+        rose_metrics_transaction_start(&metrics, &is_running);
+    }
+
+    rose_metrics_transaction_finish(&metrics, &is_running, 1000000);
+    check_(transaction_count_(metrics) == 101);
+    check_(running_transaction_count_(metrics) == 0);
+    check_(transaction_duration_count_(metrics) == 101);
+}
+
+#undef transaction_count_
+#undef running_transaction_count_
+#undef transaction_duration_count_
+
+////////////////////////////////////////////////////////////////////////////////
+// Program entry point.
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(void) {
+    rose_test_transaction_completion();
+    rose_test_transaction_restart();
+
+    return rose_test_report();
+}
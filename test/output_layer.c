@@ -0,0 +1,312 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#include "device_output_layer.h"
+#include "test.h"
+
+#include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_output_layer.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Fake backend.
+//
+// Note: The backend supports a limited number of layers, and accepts only the
+// layers which are not marked as rejected. Backend's functions replace the ones
+// from wlroots, so the test does not need a real output.
+////////////////////////////////////////////////////////////////////////////////
+
+static struct rose_test_backend {
+    // Layer limit, the number of live layers, the number of layer state
+    // submissions, and the number of successful commits.
+    size_t layer_count_max, layer_count, submission_count, commit_count;
+
+    // Layer states of the last submission.
+    struct wlr_output_layer_state* states;
+    size_t state_count;
+
+    // A mask of rejected layers, indexed by layer's position in the state
+    // array.
+    uint32_t rejection_mask;
+
+    // Flags which force state tests and commits to fail.
+    bool is_test_failing, is_commit_failing;
+} rose_test_backend;
+
+struct wlr_output_layer*
+wlr_output_layer_create(struct wlr_output* output) {
+    (void)output;
+
+    if(rose_test_backend.layer_count == rose_test_backend.layer_count_max) {
+        return NULL;
+    }
+
+    struct wlr_output_layer* layer = calloc(1, sizeof(struct wlr_output_layer));
+    if(layer != NULL) {
+        rose_test_backend.layer_count++;
+    }
+
+    return layer;
+}
+
+void
+wlr_output_layer_destroy(struct wlr_output_layer* layer) {
+    if(layer != NULL) {
+        rose_test_backend.layer_count--;
+        free(layer);
+    }
+}
+
+void
+wlr_output_state_set_layers(
+    struct wlr_output_state* state, struct wlr_output_layer_state* layers,
+    size_t layers_len) {
+    (void)state;
+
+    rose_test_backend.states = layers;
+    rose_test_backend.state_count = layers_len;
+    rose_test_backend.submission_count++;
+}
+
+bool
+wlr_output_test_state(
+    struct wlr_output* output, struct wlr_output_state const* state) {
+    (void)output;
+    (void)state;
+
+    // Accept each submitted layer which is not marked as rejected.
+    for(size_t i = 0; i != rose_test_backend.state_count; ++i) {
+        rose_test_backend.states[i].accepted =
+            ((rose_test_backend.rejection_mask >> i) & 1) == 0;
+    }
+
+    return !(rose_test_backend.is_test_failing);
+}
+
+bool
+wlr_output_commit_state(
+    struct wlr_output* output, struct wlr_output_state const* state) {
+    (void)output;
+    (void)state;
+
+    if(rose_test_backend.is_commit_failing) {
+        return false;
+    }
+
+    rose_test_backend.commit_count++;
+    return true;
+}
+
+static void
+rose_test_backend_reset(size_t layer_count_max) {
+    rose_test_backend = (struct rose_test_backend){
+        .layer_count_max = layer_count_max};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Utility functions.
+////////////////////////////////////////////////////////////////////////////////
+
+// Tries committing a frame with the given number of candidates placed on the
+// layers of the given set.
+static enum rose_output_layer_set_commit_status
+rose_test_try(
+    struct rose_output_layer_set* set, size_t candidate_count,
+    struct wlr_output_layer_state* states) {
+    static struct wlr_buffer buffers[rose_output_layer_count_max];
+    struct rose_output_layer_candidate candidates[rose_output_layer_count_max];
+
+    for(size_t i = 0; i != candidate_count; ++i) {
+        candidates[i] = (struct rose_output_layer_candidate){
+            .buffer = &(buffers[i]),
+            .src_box = {.width = 64, .height = 64},
+            .dst_box = {.x = (int)(i * 64), .width = 64, .height = 64}};
+    }
+
+    struct wlr_output_state state = {};
+    return rose_output_layer_set_try(
+        set, NULL, &state, candidates, candidate_count, states);
+}
+
+// Composes a frame: disables the layers of the given set, if needed, and
+// commits the state.
+static void
+rose_test_compose(
+    struct rose_output_layer_set* set, struct wlr_output_layer_state* states) {
+    struct wlr_output_state state = {};
+    rose_output_layer_set_disable(set, &state, states);
+    wlr_output_commit_state(NULL, &state);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Tests.
+////////////////////////////////////////////////////////////////////////////////
+
+static void
+rose_test_reserve(void) {
+    struct rose_output_layer_set set = {};
+    rose_test_backend_reset(2);
+
+    // Requests which exceed the maximum number of layers must fail.
+    check_(!rose_output_layer_set_reserve(
+        &set, NULL, rose_output_layer_count_max + 1));
+    check_(set.size == 0);
+
+    // Layers must be created on demand, and must be reused afterwards.
+    check_(rose_output_layer_set_reserve(&set, NULL, 2));
+    check_(set.size == 2);
+    check_(rose_output_layer_set_reserve(&set, NULL, 1));
+    check_(set.size == 2);
+    check_(rose_test_backend.layer_count == 2);
+
+    // If the backend can not create more layers, then reservation must fail,
+    // and already created layers must be kept.
+    check_(!rose_output_layer_set_reserve(&set, NULL, 3));
+    check_(set.size == 2);
+
+    // Destruction must release all layers.
+    rose_output_layer_set_destroy(&set);
+    check_(set.size == 0);
+    check_(rose_test_backend.layer_count == 0);
+}
+
+static void
+rose_test_placement(void) {
+    struct rose_output_layer_set set = {};
+    struct wlr_output_layer_state states[rose_output_layer_count_max];
+
+    rose_test_backend_reset(rose_output_layer_count_max);
+    check_(rose_output_layer_set_reserve(&set, NULL, 3));
+
+    // Candidates must be placed in order, unused layers must be disabled, and
+    // all layers must be submitted.
+    check_(
+        rose_test_try(&set, 2, states) ==
+        rose_output_layer_set_commit_status_success);
+    check_(rose_test_backend.state_count == set.size);
+
+    for(size_t i = 0; i != set.size; ++i) {
+        check_(states[i].layer == set.layers[i]);
+        check_((states[i].buffer != NULL) == (i < 2));
+    }
+
+    check_(states[1].dst_box.x == 64);
+
+    // Rejection of disabled layers must not prevent direct scan-out.
+    rose_test_backend.rejection_mask = 1u << 2;
+    check_(
+        rose_test_try(&set, 2, states) ==
+        rose_output_layer_set_commit_status_success);
+
+    rose_test_backend.rejection_mask = ~(uint32_t)(0);
+    check_(
+        rose_test_try(&set, 0, states) ==
+        rose_output_layer_set_commit_status_success);
+    check_(!(set.is_active));
+
+    // If the backend can not create enough layers, then the state must not be
+    // committed.
+    rose_test_backend.commit_count = 0;
+    rose_test_backend.rejection_mask = 0;
+    rose_test_backend.layer_count_max = 3;
+    check_(
+        rose_test_try(&set, 4, states) ==
+        rose_output_layer_set_commit_status_layer_rejection);
+    check_(rose_test_backend.commit_count == 0);
+
+    // Clean-up.
+    rose_output_layer_set_destroy(&set);
+}
+
+static void
+rose_test_rejection(void) {
+    struct rose_output_layer_set set = {};
+    struct wlr_output_layer_state states[rose_output_layer_count_max];
+
+    rose_test_backend_reset(rose_output_layer_count_max);
+
+    // A frame with accepted layers must be committed, and must activate the
+    // layers.
+    check_(
+        rose_test_try(&set, 2, states) ==
+        rose_output_layer_set_commit_status_success);
+    check_(rose_test_backend.commit_count == 1);
+    check_(set.is_active);
+
+    // If the backend rejects a layer which has a buffer, then the state must
+    // not be committed, and the layers must stay active until the composed
+    // frame is committed.
+    rose_test_backend.rejection_mask = 1u << 1;
+    check_(
+        rose_test_try(&set, 2, states) ==
+        rose_output_layer_set_commit_status_layer_rejection);
+    check_(rose_test_backend.commit_count == 1);
+    check_(set.is_active);
+
+    // The composed frame must disable all layers.
+    rose_test_backend.submission_count = 0;
+    rose_test_compose(&set, states);
+    check_(rose_test_backend.commit_count == 2);
+    check_(rose_test_backend.submission_count == 1);
+    check_(!(set.is_active));
+
+    for(size_t i = 0; i != set.size; ++i) {
+        check_(states[i].buffer == NULL);
+    }
+
+    // The next composed frame must not submit the layers again.
+    rose_test_compose(&set, states);
+    check_(rose_test_backend.commit_count == 3);
+    check_(rose_test_backend.submission_count == 1);
+
+    // Clean-up.
+    rose_output_layer_set_destroy(&set);
+}
+
+static void
+rose_test_failure(void) {
+    struct rose_output_layer_set set = {};
+    struct wlr_output_layer_state states[rose_output_layer_count_max];
+
+    rose_test_backend_reset(rose_output_layer_count_max);
+    check_(
+        rose_test_try(&set, 1, states) ==
+        rose_output_layer_set_commit_status_success);
+
+    // Failed tests and commits must leave the layers active, so that the
+    // composed frame disables them.
+    rose_test_backend.is_test_failing = true;
+    check_(
+        rose_test_try(&set, 0, states) ==
+        rose_output_layer_set_commit_status_test_failure);
+    check_(set.is_active);
+
+    rose_test_backend.is_test_failing = false;
+    rose_test_backend.is_commit_failing = true;
+    check_(
+        rose_test_try(&set, 0, states) ==
+        rose_output_layer_set_commit_status_commit_failure);
+    check_(rose_test_backend.commit_count == 1);
+    check_(set.is_active);
+
+    // Clean-up.
+    rose_output_layer_set_destroy(&set);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Program entry point.
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(void) {
+    rose_test_reserve();
+    rose_test_placement();
+    rose_test_rejection();
+    rose_test_failure();
+
+    return rose_test_report();
+}
@@ -0,0 +1,39 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the GNU General Public License, Version 3.
+// (See accompanying file LICENSE_GPL_3_0.txt or copy at
+// https://www.gnu.org/licenses/gpl-3.0.txt)
+//
+#ifndef H_5E1C9A3B7D2F4086A4B1E8C6D0F7392A
+#define H_5E1C9A3B7D2F4086A4B1E8C6D0F7392A
+
+#include <stdio.h>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Checking utilities.
+//
+// Note: This file must be included by exactly one translation unit of a test
+// program.
+////////////////////////////////////////////////////////////////////////////////
+
+static int rose_test_failure_count = 0;
+
+#define check_(x)                                                    \
+    if(!(x)) {                                                       \
+        printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #x); \
+        rose_test_failure_count++;                                   \
+    }
+
+// Prints the summary of performed checks. Returns program's exit status.
+static int
+rose_test_report(void) {
+    if(rose_test_failure_count != 0) {
+        printf("%d check(s) failed\n", rose_test_failure_count);
+        return EXIT_FAILURE;
+    }
+
+    printf("all checks passed\n");
+    return EXIT_SUCCESS;
+}
+
+#endif // H_5E1C9A3B7D2F4086A4B1E8C6D0F7392A